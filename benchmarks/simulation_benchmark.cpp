@@ -0,0 +1,654 @@
+/**
+ * Benchmark suite: runs scripted, fixed-seed scenarios and times whole months (SimulatorManager::trigger) as
+ * well as the individual kernels a month is made of. Results are written as JSON so that builds can be
+ * compared on the same hardware.
+ *
+ * The environment month is also timed on the hashmap container the dense grid replaced, with the same cell
+ * geometry and plants, to keep track of what the grid buys.
+ *
+ * With --compare-analyzer, the statistical snapshot of each scenario is instead checked against the prebuilt
+ * analyser: same files in its results directory, same values within _COMPARISON_TOLERANCE, same timestamp unit.
+ * Exits with 2 if any scenario differs.
+ *
+ * EcoSimBenchmark [-o results.json] [-t threads] [-s scenario,...] [-r repetitions] [-c]
+ */
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QRegExp>
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "../simulator/core/simulator_manager.h"
+#include "../simulator/plants/plant_factory.h"
+#include "../simulator/plants/plants_storage.h"
+#include "../resources/environment_manager.h"
+#include "../math/random_streams.h"
+#include "../utils/tracker_writer.h"
+#include "SpatialHashmap/spatial_hashmap.h"
+#include <radialDistribution/analysis_point.h>
+#include <radialDistribution/analyser/analyzer.h>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+#define BENCHMARK_SEED 42
+#define KERNEL_MONTH 6 // Seeding month
+#define _COMPARISON_TOLERANCE 0.05 // Relative, on the values of the analysis results
+
+const std::vector<int> _HUMIDITY     {150, 150, 120, 100, 80, 60, 50, 60, 80, 100, 120, 150};
+const std::vector<int> _ILLUMINATION {8, 9, 10, 12, 13, 14, 14, 13, 12, 10, 9, 8};
+const std::vector<int> _TEMPERATURE  {5, 6, 9, 12, 16, 20, 23, 22, 18, 13, 8, 5};
+
+struct Scenario{
+    QString name;
+    QString description;
+    SimulationConfiguration configuration;
+    int warmup_months;
+    int timed_months;
+    int kernel_repetitions;
+};
+
+/**
+ * Plant storage and environment driven directly, without a SimulatorManager, so that each kernel can be timed
+ * on its own.
+ */
+struct KernelState{
+    PlantFactory factory;
+    PlantStorage storage;
+    EnvironmentManager environment;
+    RandomStreams random_streams;
+
+    KernelState(std::shared_ptr<const SpecieTable> p_specie_table) :
+        factory(SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT, p_specie_table),
+        storage(SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT, p_specie_table),
+        environment(SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT)
+    {}
+};
+
+double elapsed_ms(Clock::time_point p_start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - p_start).count() / 1000.0;
+}
+
+QJsonObject summarize(std::vector<double> p_samples)
+{
+    QJsonObject summary;
+    if(p_samples.empty())
+        return summary;
+
+    std::sort(p_samples.begin(), p_samples.end());
+    double total(0);
+    for(double sample : p_samples)
+        total += sample;
+
+    summary.insert("samples", (int) p_samples.size());
+    summary.insert("mean_ms", total / p_samples.size());
+    summary.insert("median_ms", p_samples[p_samples.size()/2]);
+    summary.insert("min_ms", p_samples.front());
+    summary.insert("max_ms", p_samples.back());
+    return summary;
+}
+
+/*************
+ * SCENARIOS *
+ *************/
+SimulationConfiguration scenario_configuration(const std::vector<int> & p_specie_ids, int p_plant_count, bool p_seeding, int p_months,
+                                               int p_thread_count)
+{
+    std::map<int, int> plants_to_generate;
+    for(int i(0); i < p_specie_ids.size(); i++) // Even split, remainder to the first species
+        plants_to_generate[p_specie_ids[i]] = p_plant_count / p_specie_ids.size() + (i < p_plant_count % p_specie_ids.size() ? 1 : 0);
+
+    return SimulationConfiguration(plants_to_generate, 0, _HUMIDITY, _ILLUMINATION, _TEMPERATURE, p_months, p_seeding, p_thread_count,
+                                   BENCHMARK_SEED);
+}
+
+std::vector<Scenario> create_scenarios(const SpecieTable & p_specie_table, int p_thread_count, int p_repetitions)
+{
+    std::vector<const Specie*> species;
+    for(const Specie & specie : p_specie_table)
+        species.push_back(&specie);
+    std::sort(species.begin(), species.end(), [](const Specie * lhs, const Specie * rhs) {
+        return lhs->m_properties.growth_properties.max_height < rhs->m_properties.growth_properties.max_height;
+    });
+
+    std::vector<int> all_species, short_species;
+    for(const Specie * specie : species)
+        all_species.push_back(specie->m_specie_id);
+    short_species.assign(all_species.begin(), all_species.begin() + std::max(1, (int) all_species.size()/3));
+
+    std::vector<Scenario> scenarios;
+    {
+        Scenario scenario;
+        scenario.name = "sparse_grassland";
+        scenario.description = "Shortest third of the species, 2000 plants, seeding";
+        scenario.warmup_months = 36;
+        scenario.timed_months = 24;
+        scenario.kernel_repetitions = 10 * p_repetitions;
+        scenario.configuration = scenario_configuration(short_species, 2000, true, scenario.warmup_months + scenario.timed_months, p_thread_count);
+        scenarios.push_back(scenario);
+    }
+    {
+        Scenario scenario;
+        scenario.name = "dense_mixed_forest";
+        scenario.description = "Every specie, 100000 plants, seeding";
+        scenario.warmup_months = 12;
+        scenario.timed_months = 12;
+        scenario.kernel_repetitions = 5 * p_repetitions;
+        scenario.configuration = scenario_configuration(all_species, 100000, true, scenario.warmup_months + scenario.timed_months, p_thread_count);
+        scenarios.push_back(scenario);
+    }
+    {
+        Scenario scenario;
+        scenario.name = "stress_1m";
+        scenario.description = "Every specie, 1000000 plants, no seeding";
+        scenario.warmup_months = 0;
+        scenario.timed_months = 3;
+        scenario.kernel_repetitions = p_repetitions;
+        scenario.configuration = scenario_configuration(all_species, 1000000, false, scenario.warmup_months + scenario.timed_months, p_thread_count);
+        scenarios.push_back(scenario);
+    }
+
+    return scenarios;
+}
+
+/**********
+ * MONTHS *
+ **********/
+QJsonObject benchmark_months(const Scenario & p_scenario, std::shared_ptr<const SpecieTable> p_specie_table)
+{
+    SimulatorManager simulator_manager(p_specie_table);
+
+    auto setup_start(Clock::now());
+    simulator_manager.setConfiguration(p_scenario.configuration);
+    double setup_time(elapsed_ms(setup_start));
+
+    for(int month(0); month < p_scenario.warmup_months; month++)
+        simulator_manager.trigger();
+
+    int start_plant_count(simulator_manager.getPlantCount());
+    std::vector<double> monthly_times;
+    QJsonArray monthly_times_array, monthly_plant_counts;
+    for(int month(0); month < p_scenario.timed_months; month++)
+    {
+        auto start(Clock::now());
+        simulator_manager.trigger();
+        monthly_times.push_back(elapsed_ms(start));
+        monthly_times_array.append(monthly_times.back());
+        monthly_plant_counts.append(simulator_manager.getPlantCount());
+    }
+
+    QJsonObject months(summarize(monthly_times));
+    months.insert("setup_ms", setup_time);
+    months.insert("warmup_months", p_scenario.warmup_months);
+    months.insert("start_plant_count", start_plant_count);
+    months.insert("monthly_ms", monthly_times_array);
+    months.insert("monthly_plant_count", monthly_plant_counts);
+    return months;
+}
+
+/***********
+ * KERNELS *
+ ***********/
+void add_plant(KernelState & p_state, Plant p_plant)
+{
+    if(!p_state.storage.isPlantAtLocation(p_plant.m_center_position))
+    {
+        p_state.storage.add(p_plant);
+        p_state.environment.updateEnvironment(p_plant.m_center_position, p_plant.getCanopyWidth(), p_plant.getHeight(), p_plant.getRootSize(),
+                                              p_plant.m_unique_id, p_plant.getMinimumSoilHumidityRequirement());
+    }
+}
+
+// Same initial population as SimulatorManager::setConfiguration
+void populate(KernelState & p_state, const SimulationConfiguration & p_configuration)
+{
+    p_state.random_streams = RandomStreams(p_configuration.m_seed);
+    p_state.factory.setRandomStreams(p_state.random_streams);
+    p_state.storage.setThreadCount(p_configuration.m_thread_count);
+    p_state.environment.setEnvironmentProperties(p_configuration.m_slope, p_configuration.m_humidity, p_configuration.m_illumination,
+                                                 p_configuration.m_temperature);
+    p_state.environment.setMonth(KERNEL_MONTH);
+
+    for(auto it(p_configuration.m_plants_to_generate.begin()); it != p_configuration.m_plants_to_generate.end(); it++)
+    {
+        for(int i(0); i < it->second; i++)
+            add_plant(p_state, p_state.factory.generate(it->first));
+    }
+}
+
+// Rasterization of every canopy and root disc
+double footprint_kernel(KernelState & p_state, const std::vector<Plant> & p_plants)
+{
+    const EnvironmentSpatialHashMap & map(p_state.environment.getRenderingData());
+    long covered_spans(0);
+
+    auto start(Clock::now());
+    for(const Plant & p : p_plants)
+    {
+        for(CellSpan span : map.getFootprint(p.m_center_position, p.getCanopyWidth()/2))
+            covered_spans += span.y_end - span.y_begin;
+        for(CellSpan span : map.getFootprint(p.m_center_position, p.getRootSize()))
+            covered_spans += span.y_end - span.y_begin;
+    }
+    double time(elapsed_ms(start));
+
+    if(covered_spans < 0)
+        std::cerr << "Invalid checksum" << std::endl;
+    return time;
+}
+
+// Full re-stamp of the environment (the monthly update only stamps what changed)
+double environment_stamp_kernel(KernelState & p_state, const std::vector<Plant> & p_plants)
+{
+    p_state.environment.reset();
+
+    auto start(Clock::now());
+    for(const Plant & p : p_plants)
+        p_state.environment.updateEnvironment(p.m_center_position, p.getCanopyWidth(), p.getHeight(), p.getRootSize(), p.m_unique_id,
+                                              p.getMinimumSoilHumidityRequirement());
+    return elapsed_ms(start);
+}
+
+// Stamps a standalone map so that the illumination and soil humidity kernels can be timed separately
+void stamp(EnvironmentSpatialHashMap & p_map, EnvironmentSoilHumidity & p_soil_humidity, const std::vector<Plant> & p_plants)
+{
+    EnvironmentIllumination illumination;
+    for(const Plant & p : p_plants)
+    {
+        if(p.getCanopyWidth() > 0)
+            illumination.update(p_map, Footprint(), p_map.getFootprint(p.m_center_position, p.getCanopyWidth()/2), p.getHeight(), p.m_unique_id);
+        p_soil_humidity.update(p_map, Footprint(), p_map.getFootprint(p.m_center_position, p.getRootSize()), p.getRootSize(), p.m_unique_id,
+                               p.getMinimumSoilHumidityRequirement());
+    }
+}
+
+// Every plant grows taller within its canopy, the cells it covers updating their tallest occupant
+double illumination_growth_kernel(EnvironmentSpatialHashMap & p_map, const std::vector<Plant> & p_plants, int p_repetition)
+{
+    auto start(Clock::now());
+    for(const Plant & p : p_plants)
+    {
+        if(p.getCanopyWidth() > 0)
+            p_map.setPlantHeight(p.m_unique_id, p.getHeight() + 1 + p_repetition, p_map.getFootprint(p.m_center_position, p.getCanopyWidth()/2));
+    }
+    return elapsed_ms(start);
+}
+
+double soil_humidity_solve_kernel(EnvironmentSpatialHashMap & p_map, EnvironmentSoilHumidity & p_soil_humidity)
+{
+    auto start(Clock::now());
+    p_soil_humidity.solve(p_map);
+    return elapsed_ms(start);
+}
+
+// Evaluation and commit of every plant. The environment is then brought up to date as SimulatorManager::trigger does.
+double plant_storage_update_kernel(KernelState & p_state, int p_elapsed_months)
+{
+    std::vector<Plant> surviving_plants, deceased_plants;
+    p_state.environment.setMonth((p_elapsed_months % 12) + 1);
+
+    auto start(Clock::now());
+    p_state.storage.update(p_state.environment, p_state.random_streams, p_elapsed_months, surviving_plants, deceased_plants);
+    double time(elapsed_ms(start));
+
+    for(Plant & p : surviving_plants)
+        p_state.environment.updateEnvironment(p.m_center_position, p.getCanopyWidth(), p.getHeight(), p.getRootSize(), p.m_unique_id,
+                                              p.getMinimumSoilHumidityRequirement());
+    for(Plant & p : deceased_plants)
+        p_state.environment.remove(p.m_center_position, p.getCanopyWidth(), p.getRootSize(), p.m_unique_id);
+
+    return time;
+}
+
+// Dispersal of every specie's seeds from its existing plants, as in SimulatorManager::trigger
+double seeding_kernel(KernelState & p_state, int p_elapsed_months)
+{
+    auto start(Clock::now());
+    for(int specie_id : p_state.storage.getSpecieIds())
+    {
+        if(!p_state.storage.containsSpecie(specie_id))
+            continue;
+
+        int seed_count(p_state.factory.getSpecieProperties(specie_id).seeding_properties.seed_count);
+        RandomStream random_stream(p_state.random_streams.stream(RandomStreams::Seeding, specie_id, p_elapsed_months));
+        std::vector<Plant> seeding_plants(p_state.storage.getOnePlantPerCell(specie_id, random_stream));
+
+        for(int i(0); i < seed_count; i++)
+        {
+            QPoint position(seeding_plants[i % seeding_plants.size()].seed(1, random_stream).at(0));
+            if(position.x() >= 0 && position.x() < SimulatorManager::_AREA_WIDTH_HEIGHT &&
+                    position.y() >= 0 && position.y() < SimulatorManager::_AREA_WIDTH_HEIGHT)
+                add_plant(p_state, p_state.factory.generate(specie_id, position));
+        }
+    }
+    return elapsed_ms(start);
+}
+
+/**************************
+ * ENVIRONMENT CONTAINERS *
+ **************************/
+typedef SpatialHashMap<EnvironmentSpatialHashMapCell> HashMapEnvironment;
+
+EnvironmentSpatialHashMapCell & cell(std::pair<const QPoint, EnvironmentSpatialHashMapCell> & p_entry) { return p_entry.second; }
+EnvironmentSpatialHashMapCell & cell(EnvironmentSpatialHashMapCell & p_cell) { return p_cell; }
+
+// Heights and humidity requests by plant id, as EnvironmentSpatialHashMap keeps them
+struct PlantTables{
+    std::vector<float> heights;
+    std::vector<ResourceUsageRequest> requests;
+
+    PlantTables(const std::vector<Plant> & p_plants)
+    {
+        for(const Plant & p : p_plants)
+        {
+            if(p.m_unique_id >= heights.size())
+            {
+                heights.resize(p.m_unique_id+1, .0f);
+                requests.resize(p.m_unique_id+1);
+            }
+            heights[p.m_unique_id] = p.getHeight();
+            requests[p.m_unique_id] = ResourceUsageRequest(p.getMinimumSoilHumidityRequirement(), p.getRootSize(), p.m_unique_id);
+        }
+    }
+};
+
+// Cell membership of both resources, through the cell lists both containers expose
+template <class Map> void stamp_cells(Map & p_map, const std::vector<Plant> & p_plants, const PlantTables & p_tables)
+{
+    for(const Plant & p : p_plants)
+    {
+        for(QPoint & point : p_map.getPoints(p.m_center_position, p.getCanopyWidth()/2, true))
+            p_map.getCell(point, Map::Space::_HASHMAP).illumination_cell.add(p.m_unique_id, p_tables.heights);
+        for(QPoint & point : p_map.getPoints(p.m_center_position, p.getRootSize(), true))
+            p_map.getCell(point, Map::Space::_HASHMAP).soil_humidity_cell.add(p.m_unique_id, p_tables.requests);
+    }
+}
+
+// Height and request updates over the footprints, soil humidity grants, illumination reads and re-stamp of every plant
+template <class Map> double environment_month_kernel(Map & p_map, const std::vector<Plant> & p_plants, const PlantTables & p_tables)
+{
+    auto start(Clock::now());
+    for(const Plant & p : p_plants)
+    {
+        for(QPoint & point : p_map.getPoints(p.m_center_position, p.getCanopyWidth()/2, true))
+            p_map.getCell(point, Map::Space::_HASHMAP).illumination_cell.setHeight(p.m_unique_id, p_tables.heights);
+        for(QPoint & point : p_map.getPoints(p.m_center_position, p.getRootSize(), true))
+            p_map.getCell(point, Map::Space::_HASHMAP).soil_humidity_cell.setRequest(p.m_unique_id, p_tables.requests);
+    }
+
+    std::vector<int> granted_humidity_totals(p_tables.requests.size(), 0);
+    for(auto it(p_map.begin()); it != p_map.end(); it++)
+        cell(*it).soil_humidity_cell.grant(granted_humidity_totals, _HUMIDITY[KERNEL_MONTH-1], p_tables.requests);
+
+    long checksum(0);
+    for(const Plant & p : p_plants)
+    {
+        for(QPoint & point : p_map.getPoints(p.m_center_position, p.getCanopyWidth()/2, true))
+            checksum += p_map.getCell(point, Map::Space::_HASHMAP).illumination_cell.getIllumination(p.m_unique_id, p.getHeight(),
+                                                                                                   _ILLUMINATION[KERNEL_MONTH-1]);
+        checksum += granted_humidity_totals[p.m_unique_id];
+    }
+    stamp_cells(p_map, p_plants, p_tables);
+    double time(elapsed_ms(start));
+
+    if(checksum < 0)
+        std::cerr << "Invalid checksum" << std::endl;
+    return time;
+}
+
+QJsonObject benchmark_kernels(const Scenario & p_scenario, std::shared_ptr<const SpecieTable> p_specie_table)
+{
+    KernelState state(p_specie_table);
+    populate(state, p_scenario.configuration);
+    std::vector<Plant> plants(state.storage.getPlants());
+
+    std::vector<double> footprint_times, stamp_times, illumination_times, soil_humidity_times, update_times, seeding_times,
+            hashmap_month_times, grid_month_times;
+    for(int i(0); i < p_scenario.kernel_repetitions; i++)
+    {
+        footprint_times.push_back(footprint_kernel(state, plants));
+        stamp_times.push_back(environment_stamp_kernel(state, plants));
+    }
+    {
+        EnvironmentSpatialHashMap map(SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT);
+        map.setAvailableResources(_ILLUMINATION[KERNEL_MONTH-1], _HUMIDITY[KERNEL_MONTH-1], _TEMPERATURE[KERNEL_MONTH-1]);
+        EnvironmentSoilHumidity soil_humidity;
+        stamp(map, soil_humidity, plants);
+
+        for(int i(0); i < p_scenario.kernel_repetitions; i++)
+        {
+            illumination_times.push_back(illumination_growth_kernel(map, plants, i));
+            soil_humidity_times.push_back(soil_humidity_solve_kernel(map, soil_humidity));
+        }
+    }
+    {
+        PlantTables tables(plants);
+        EnvironmentSpatialHashMap grid(SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT);
+        HashMapEnvironment hashmap(grid.getCellWidth(), grid.getCellHeight(), grid.getHorizontalCellCount(), grid.getVerticalCellCount());
+        stamp_cells(grid, plants, tables);
+        stamp_cells(hashmap, plants, tables);
+
+        for(int i(0); i < p_scenario.kernel_repetitions; i++)
+        {
+            hashmap_month_times.push_back(environment_month_kernel(hashmap, plants, tables));
+            grid_month_times.push_back(environment_month_kernel(grid, plants, tables));
+        }
+    }
+    // Mutates the population: run last
+    for(int i(0); i < p_scenario.kernel_repetitions; i++)
+    {
+        update_times.push_back(plant_storage_update_kernel(state, KERNEL_MONTH + 12 * i));
+        seeding_times.push_back(seeding_kernel(state, KERNEL_MONTH + 12 * i));
+    }
+
+    QJsonObject kernels;
+    kernels.insert("plant_count", (int) plants.size());
+    kernels.insert("footprint", summarize(footprint_times));
+    kernels.insert("environment_stamp", summarize(stamp_times));
+    kernels.insert("illumination_growth", summarize(illumination_times));
+    kernels.insert("soil_humidity_solve", summarize(soil_humidity_times));
+    kernels.insert("plant_storage_update", summarize(update_times));
+    kernels.insert("seeding", summarize(seeding_times));
+    kernels.insert("hashmap_environment_month", summarize(hashmap_month_times));
+    kernels.insert("grid_environment_month", summarize(grid_month_times));
+    return kernels;
+}
+
+/*********************
+ * ANALYZER BASELINE *
+ *********************/
+// Every number of the file, in order
+std::vector<double> read_values(const QString & p_filename)
+{
+    std::vector<double> values;
+    QFile file(p_filename);
+    if(!file.open(QIODevice::ReadOnly))
+        return values;
+
+    QString content(QString::fromUtf8(file.readAll()));
+    QRegExp number("[-+]?[0-9]*\\.?[0-9]+([eE][-+]?[0-9]+)?");
+    for(int position(0); (position = number.indexIn(content, position)) != -1; position += number.matchedLength())
+        values.push_back(number.cap(0).toDouble());
+    return values;
+}
+
+bool same_values(const std::vector<double> & p_baseline, const std::vector<double> & p_values)
+{
+    if(p_baseline.size() != p_values.size())
+        return false;
+    for(int i(0); i < p_baseline.size(); i++)
+    {
+        if(std::fabs(p_baseline[i] - p_values[i]) > _COMPARISON_TOLERANCE * std::max(1.0, std::fabs(p_baseline[i])))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * The scenario's plants after its warmup, analysed by the prebuilt analyser and by the in-tree one as the statistical
+ * snapshot does (species prioritized by decreasing average height), results written to the directory the tracker reads.
+ */
+QJsonObject compare_analyzers(const Scenario & p_scenario, std::shared_ptr<const SpecieTable> p_specie_table, bool & p_matching)
+{
+    KernelState state(p_specie_table);
+    populate(state, p_scenario.configuration);
+    for(int month(0); month < p_scenario.warmup_months; month++)
+        plant_storage_update_kernel(state, month);
+
+    std::map<int, std::vector<AnalysisPoint> > baseline_points;
+    RadialDistributionAnalyzer::Categories points;
+    std::map<int, float> total_heights;
+    std::vector<Plant> plants(state.storage.getPlants());
+    for(const Plant & p : plants)
+    {
+        int specie_id(p.m_specie->m_specie_id);
+        baseline_points[specie_id].push_back(AnalysisPoint(specie_id, p.m_center_position, std::max(1.0f,p.getCanopyWidth()/2.0f), p.getRootSize(),
+                                                           p.getHeight()));
+        points[specie_id].push_back(RadialDistributionAnalyzer::Point{p.m_center_position, std::max(1.0f,p.getCanopyWidth()/2.0f)});
+        total_heights[specie_id] += p.getHeight();
+    }
+    std::map<float,int> avg_height_to_specie_id;
+    for(auto specie(points.begin()); specie != points.end(); specie++)
+    {
+        float avg_height(total_heights[specie->first] / specie->second.size());
+        while(avg_height_to_specie_id.find(avg_height) != avg_height_to_specie_id.end())
+            avg_height++;
+        avg_height_to_specie_id.emplace(avg_height, specie->first);
+    }
+    std::vector<int> priority_sorted_ids;
+    for(auto it(avg_height_to_specie_id.rbegin()); it != avg_height_to_specie_id.rend(); it++)
+        priority_sorted_ids.push_back(it->second);
+
+    QTemporaryDir baseline_directory, directory;
+    AnalysisConfiguration configuration(0, 200, 20, SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT);
+    configuration.setPrioritySortedCategoryIds(priority_sorted_ids);
+
+    auto baseline_start(Clock::now());
+    unsigned long baseline_timestamp(Analyzer::analyze(baseline_directory.path(), baseline_points, configuration));
+    double baseline_time(elapsed_ms(baseline_start));
+
+    ThreadPool thread_pool(p_scenario.configuration.m_thread_count > 0 ? p_scenario.configuration.m_thread_count : ThreadPool::defaultThreadCount());
+    RadialDistributionAnalyzer analyzer(0, 200, 20, SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT);
+    auto start(Clock::now());
+    bool written(RadialDistributionAnalyzer::write(analyzer.analyze(points, priority_sorted_ids, thread_pool), directory.path()));
+    unsigned long timestamp(TrackerWriter::timestamp());
+    double time(elapsed_ms(start));
+
+    QStringList baseline_files(QDir(baseline_directory.path()).entryList(QDir::Files, QDir::Name));
+    QStringList files(QDir(directory.path()).entryList(QDir::Files, QDir::Name));
+    QJsonArray missing_files, extra_files, differing_files;
+    for(const QString & file : baseline_files)
+    {
+        if(!files.contains(file))
+            missing_files.append(file);
+        else if(!same_values(read_values(baseline_directory.path() + "/" + file), read_values(directory.path() + "/" + file)))
+            differing_files.append(file);
+    }
+    for(const QString & file : files)
+    {
+        if(!baseline_files.contains(file))
+            extra_files.append(file);
+    }
+    // Same unit: both taken from the wall clock a moment apart
+    bool same_timestamp_unit(std::max(baseline_timestamp, timestamp) - std::min(baseline_timestamp, timestamp) < 3600);
+
+    bool matching(written && missing_files.isEmpty() && extra_files.isEmpty() && differing_files.isEmpty() && same_timestamp_unit);
+    p_matching = p_matching && matching;
+
+    QJsonObject comparison;
+    comparison.insert("matching", matching);
+    comparison.insert("plant_count", (int) plants.size());
+    comparison.insert("baseline_ms", baseline_time);
+    comparison.insert("ms", time);
+    comparison.insert("missing_files", missing_files);
+    comparison.insert("extra_files", extra_files);
+    comparison.insert("differing_files", differing_files);
+    comparison.insert("baseline_timestamp", QString::number(baseline_timestamp));
+    comparison.insert("timestamp", QString::number(timestamp));
+    return comparison;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("EcoSimBenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times fixed-seed simulation scenarios and their kernels.");
+    parser.addHelpOption();
+    QCommandLineOption output_option(QStringList() << "o" << "output", "Results file (JSON). Standard output if omitted.", "file");
+    QCommandLineOption threads_option(QStringList() << "t" << "threads", "Threads evaluating the plants (0 --> one per core).", "count", "0");
+    QCommandLineOption scenarios_option(QStringList() << "s" << "scenarios", "Comma separated scenarios to run (all by default).", "names");
+    QCommandLineOption repetitions_option(QStringList() << "r" << "repetitions", "Multiplies the kernel repetitions.", "count", "1");
+    QCommandLineOption compare_option(QStringList() << "c" << "compare-analyzer", "Checks the statistical snapshots against the prebuilt analyser instead.");
+    parser.addOption(output_option);
+    parser.addOption(threads_option);
+    parser.addOption(scenarios_option);
+    parser.addOption(repetitions_option);
+    parser.addOption(compare_option);
+    parser.process(app);
+
+    int thread_count(parser.value(threads_option).toInt());
+    QStringList selected_scenarios(parser.value(scenarios_option).split(",", QString::SkipEmptyParts));
+
+    std::shared_ptr<const SpecieTable> specie_table(SpecieTable::load());
+
+    bool matching(true);
+    QJsonArray scenario_results;
+    for(const Scenario & scenario : create_scenarios(*specie_table, thread_count, std::max(1, parser.value(repetitions_option).toInt())))
+    {
+        if(!selected_scenarios.empty() && !selected_scenarios.contains(scenario.name))
+            continue;
+
+        std::cerr << "Scenario " << scenario.name.toStdString() << "..." << std::endl;
+
+        QJsonObject result;
+        result.insert("name", scenario.name);
+        result.insert("description", scenario.description);
+        if(parser.isSet(compare_option))
+        {
+            result.insert("analyzer_comparison", compare_analyzers(scenario, specie_table, matching));
+        }
+        else
+        {
+            result.insert("months", benchmark_months(scenario, specie_table));
+            result.insert("kernels", benchmark_kernels(scenario, specie_table));
+        }
+        scenario_results.append(result);
+    }
+
+    QJsonObject results;
+    results.insert("seed", BENCHMARK_SEED);
+    results.insert("threads", thread_count > 0 ? thread_count : ThreadPool::defaultThreadCount());
+    results.insert("compiler", QString(__VERSION__));
+    results.insert("scenarios", scenario_results);
+
+    int exit_code(matching ? 0 : 2);
+
+    QByteArray json(QJsonDocument(results).toJson());
+    if(!parser.isSet(output_option))
+    {
+        std::cout << json.constData();
+        return exit_code;
+    }
+
+    QFile output(parser.value(output_option));
+    if(!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        std::cerr << "Unable to write results to " << parser.value(output_option).toStdString() << std::endl;
+        return 1;
+    }
+    output.write(json);
+    return exit_code;
+}
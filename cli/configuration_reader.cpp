@@ -0,0 +1,137 @@
+#include "configuration_reader.h"
+#include "../simulator/plants/specie.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSettings>
+#include <QStringList>
+
+#include <limits>
+#include <cmath>
+
+#define MONTHS_PER_YEAR 12
+
+SimulationConfiguration ConfigurationReader::read(const QString & p_filename, const SpecieTable & p_specie_table)
+{
+    if(!QFileInfo(p_filename).isReadable())
+        throw InvalidConfigurationException(QString("Unable to read configuration file: ").append(p_filename));
+
+    SimulationConfiguration configuration(QFileInfo(p_filename).suffix().toLower() == "json" ? fromJson(readJsonObject(p_filename)) : read_ini(p_filename));
+    validate(configuration, p_specie_table);
+
+    return configuration;
+}
+
+QJsonObject ConfigurationReader::readJsonObject(const QString & p_filename)
+{
+    QFile file(p_filename);
+    if(!file.open(QIODevice::ReadOnly))
+        throw InvalidConfigurationException(QString("Unable to read configuration file: ").append(p_filename));
+
+    QJsonParseError error;
+    QJsonDocument document(QJsonDocument::fromJson(file.readAll(), &error));
+    if(error.error != QJsonParseError::NoError || !document.isObject())
+        throw InvalidConfigurationException(QString("Invalid JSON configuration: ").append(error.errorString()));
+
+    return document.object();
+}
+
+SimulationConfiguration ConfigurationReader::fromJson(const QJsonObject & p_root)
+{
+    SimulationConfiguration configuration;
+
+    QJsonObject species(p_root.value("species").toObject());
+    for(auto it(species.begin()); it != species.end(); it++)
+        configuration.m_plants_to_generate.emplace(parse_specie_id(it.key()), it.value().toInt());
+
+    configuration.m_slope = p_root.value("slope").toDouble(0);
+    for(QJsonValue value : p_root.value("humidity").toArray())
+        configuration.m_humidity.push_back(value.toInt());
+    for(QJsonValue value : p_root.value("illumination").toArray())
+        configuration.m_illumination.push_back(value.toInt());
+    for(QJsonValue value : p_root.value("temperature").toArray())
+        configuration.m_temperature.push_back(value.toInt());
+
+    configuration.m_duration = p_root.value("duration").toInt(0);
+    configuration.m_seeding_enabled = p_root.value("seeding").toBool(true);
+    configuration.m_thread_count = p_root.value("threads").toInt(0);
+    if(p_root.contains("seed"))
+    {
+        double seed(p_root.value("seed").toDouble(-1));
+        if(seed < 0 || seed > std::numeric_limits<unsigned int>::max() || seed != std::floor(seed))
+            throw InvalidConfigurationException("The seed must be an integer between 0 and 4294967295");
+        configuration.m_seed = (unsigned int) seed;
+    }
+
+    return configuration;
+}
+
+SimulationConfiguration ConfigurationReader::read_ini(const QString & p_filename)
+{
+    QSettings settings(p_filename, QSettings::IniFormat);
+    if(settings.status() != QSettings::NoError)
+        throw InvalidConfigurationException(QString("Invalid INI configuration: ").append(p_filename));
+
+    SimulationConfiguration configuration;
+
+    settings.beginGroup("species");
+    for(const QString & key : settings.childKeys())
+        configuration.m_plants_to_generate.emplace(parse_specie_id(key), settings.value(key).toInt());
+    settings.endGroup();
+
+    settings.beginGroup("simulation");
+    configuration.m_slope = settings.value("slope", 0).toFloat();
+    // Comma separated values are read as string lists
+    for(const QString & value : settings.value("humidity").toStringList())
+        configuration.m_humidity.push_back(value.trimmed().toInt());
+    for(const QString & value : settings.value("illumination").toStringList())
+        configuration.m_illumination.push_back(value.trimmed().toInt());
+    for(const QString & value : settings.value("temperature").toStringList())
+        configuration.m_temperature.push_back(value.trimmed().toInt());
+
+    configuration.m_duration = settings.value("duration", 0).toInt();
+    configuration.m_seeding_enabled = settings.value("seeding", true).toBool();
+    configuration.m_thread_count = settings.value("threads", 0).toInt();
+    if(settings.contains("seed"))
+    {
+        bool valid_seed(false);
+        configuration.m_seed = settings.value("seed").toString().trimmed().toUInt(&valid_seed);
+        if(!valid_seed)
+            throw InvalidConfigurationException("The seed must be an integer between 0 and 4294967295");
+    }
+    settings.endGroup();
+
+    return configuration;
+}
+
+int ConfigurationReader::parse_specie_id(const QString & p_key)
+{
+    bool valid_id(false);
+    int specie_id(p_key.trimmed().toInt(&valid_id));
+    if(!valid_id)
+        throw InvalidConfigurationException(QString("Invalid specie id: ").append(p_key));
+
+    return specie_id;
+}
+
+void ConfigurationReader::validate(const SimulationConfiguration & p_configuration, const SpecieTable & p_specie_table)
+{
+    if(p_configuration.m_plants_to_generate.empty())
+        throw InvalidConfigurationException("No species specified");
+    for(auto it(p_configuration.m_plants_to_generate.begin()); it != p_configuration.m_plants_to_generate.end(); it++)
+    {
+        if(!p_specie_table.contains(it->first))
+            throw InvalidConfigurationException(QString("Unknown specie id: ").append(QString::number(it->first)));
+    }
+    if(p_configuration.m_humidity.size() != MONTHS_PER_YEAR)
+        throw InvalidConfigurationException("Exactly 12 monthly humidity values are required");
+    if(p_configuration.m_illumination.size() != MONTHS_PER_YEAR)
+        throw InvalidConfigurationException("Exactly 12 monthly illumination values are required");
+    if(p_configuration.m_temperature.size() != MONTHS_PER_YEAR)
+        throw InvalidConfigurationException("Exactly 12 monthly temperature values are required");
+    if(p_configuration.m_duration <= 0)
+        throw InvalidConfigurationException("The duration (in months) must be positive");
+}
@@ -0,0 +1,58 @@
+#ifndef CONFIGURATION_READER_H
+#define CONFIGURATION_READER_H
+
+#include <exception>
+#include <string>
+#include <QString>
+#include <QJsonObject>
+#include "../simulator/core/simulation_configuration.h"
+
+class SpecieTable;
+
+/**
+ * Reads a SimulationConfiguration from a JSON (.json) or INI (any other suffix) file.
+ *
+ * JSON:
+ *  { "species": { "<specie id>": <plant count, -1 for the seeding quantity>, ... },
+ *    "slope": 0, "humidity": [12 values], "illumination": [12 values], "temperature": [12 values],
+ *    "duration": <months>, "seeding": true, "threads": 0, "seed": <optional> }
+ *
+ * INI:
+ *  [simulation]
+ *  slope=0
+ *  humidity=<12 comma separated values>
+ *  illumination=<12 comma separated values>
+ *  temperature=<12 comma separated values>
+ *  duration=<months>
+ *  seeding=true
+ *  threads=0
+ *  seed=<optional>
+ *  [species]
+ *  <specie id>=<plant count, -1 for the seeding quantity>
+ */
+class ConfigurationReader
+{
+public:
+    class InvalidConfigurationException : public std::exception
+    {
+    public:
+        InvalidConfigurationException(const QString & p_reason) : m_reason(p_reason.toStdString()) {}
+        virtual const char* what() const noexcept
+        {
+            return m_reason.c_str();
+        }
+    private:
+        std::string m_reason;
+    };
+
+    static SimulationConfiguration read(const QString & p_filename, const SpecieTable & p_specie_table);
+    static SimulationConfiguration fromJson(const QJsonObject & p_root); // Not validated
+    static QJsonObject readJsonObject(const QString & p_filename);
+    static void validate(const SimulationConfiguration & p_configuration, const SpecieTable & p_specie_table); // Specie ids must be in the table
+
+private:
+    static SimulationConfiguration read_ini(const QString & p_filename);
+    static int parse_specie_id(const QString & p_key);
+};
+
+#endif // CONFIGURATION_READER_H
@@ -0,0 +1,221 @@
+#include "ensemble_runner.h"
+#include "configuration_reader.h"
+#include "../simulator/core/simulator_manager.h"
+#include "../simulator/plants/specie.h"
+#include "../utils/thread_pool.h"
+
+#include <QJsonArray>
+#include <QStringList>
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <math.h>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+EnsembleRunner::EnsembleRunner(const QString & p_sweep_filename) : m_specie_table(SpecieTable::load()), m_runs(), m_combination_count(0)
+{
+    QJsonObject definition(ConfigurationReader::readJsonObject(p_sweep_filename));
+    QJsonObject base(definition.value("base").toObject());
+    QJsonObject sweep(definition.value("sweep").toObject());
+    int replicates(definition.value("replicates").toInt(1));
+    if(replicates < 1)
+        throw ConfigurationReader::InvalidConfigurationException("At least one replicate is required");
+
+    // Cartesian product of the swept values
+    std::vector<QJsonObject> combinations(1, QJsonObject());
+    QStringList swept_keys(sweep.keys());
+    for(const QString & key : swept_keys)
+    {
+        QJsonArray values(sweep.value(key).toArray());
+        if(values.size() == 0)
+            throw ConfigurationReader::InvalidConfigurationException(QString("No values to sweep for: ").append(key));
+
+        std::vector<QJsonObject> extended_combinations;
+        for(const QJsonObject & combination : combinations)
+        {
+            for(QJsonValue value : values)
+            {
+                QJsonObject extended_combination(combination);
+                extended_combination.insert(key, value);
+                extended_combinations.push_back(extended_combination);
+            }
+        }
+        combinations = extended_combinations;
+    }
+    m_combination_count = combinations.size();
+
+    // Replicate n of every combination shares the same seed so combinations are compared on the same random draws
+    if(!base.contains("seed"))
+        base.insert("seed", (double) SimulationConfiguration::randomSeed());
+
+    for(int combination(0); combination < m_combination_count; combination++)
+    {
+        QJsonObject configuration_object(base);
+        for(const QString & key : swept_keys)
+            configuration_object.insert(key, combinations[combination].value(key));
+
+        SimulationConfiguration configuration(ConfigurationReader::fromJson(configuration_object));
+        ConfigurationReader::validate(configuration, *m_specie_table);
+        configuration.m_thread_count = 1; // The ensemble is parallelised across simulations
+
+        for(int replicate(0); replicate < replicates; replicate++)
+        {
+            Run run;
+            run.combination = combination;
+            run.replicate = replicate;
+            run.parameters = combinations[combination];
+            run.configuration = configuration;
+            run.configuration.m_seed = configuration.m_seed + replicate;
+            m_runs.push_back(run);
+        }
+    }
+}
+
+int EnsembleRunner::getRunCount() const
+{
+    return m_runs.size();
+}
+
+QJsonObject EnsembleRunner::run(int p_thread_count)
+{
+    // Longest simulations first to limit the idle tail
+    std::vector<int> run_order(m_runs.size());
+    for(int i(0); i < run_order.size(); i++)
+        run_order[i] = i;
+    std::stable_sort(run_order.begin(), run_order.end(), [this](int lhs, int rhs) {
+        return m_runs[lhs].configuration.m_duration > m_runs[rhs].configuration.m_duration;
+    });
+
+    std::vector<RunResult> results(m_runs.size());
+    std::atomic<int> completed_runs(0);
+    std::mutex output_mutex;
+
+    ThreadPool thread_pool(p_thread_count > 0 ? p_thread_count : ThreadPool::defaultThreadCount());
+    thread_pool.run(m_runs.size(), [&](int p_task, int p_thread_idx) {
+        int run_idx(run_order[p_task]);
+        results[run_idx] = run_simulation(m_runs[run_idx], m_specie_table);
+
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::cerr << "Run " << ++completed_runs << " / " << m_runs.size() << " complete ("
+                  << results[run_idx].elapsed_months << " months, " << results[run_idx].simulation_time << "ms)" << std::endl;
+    });
+
+    return aggregate(results, *m_specie_table);
+}
+
+EnsembleRunner::RunResult EnsembleRunner::run_simulation(const Run & p_run, std::shared_ptr<const SpecieTable> p_specie_table) const
+{
+    SimulatorManager simulator_manager(p_specie_table);
+
+    auto start(Clock::now());
+    simulator_manager.setConfiguration(p_run.configuration);
+
+    RunResult result;
+    result.extinct = false;
+    while(simulator_manager.getElapsedMonths() < p_run.configuration.m_duration)
+    {
+        simulator_manager.trigger();
+        if(simulator_manager.getPlantCount() == 0) // Every specie is extinct
+        {
+            result.extinct = true;
+            break;
+        }
+    }
+
+    result.simulation_time = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    result.elapsed_months = simulator_manager.getElapsedMonths();
+    result.plant_count = simulator_manager.getPlantCount();
+    result.specie_plant_counts = simulator_manager.getSpeciePlantCounts();
+
+    return result;
+}
+
+/**
+ * Individual runs plus, per parameter combination, the mean and standard deviation of the final plant counts
+ * over the replicates.
+ */
+QJsonObject EnsembleRunner::aggregate(const std::vector<RunResult> & p_results, const SpecieTable & p_specie_table) const
+{
+    QJsonArray runs;
+    std::vector<std::vector<const RunResult*> > combination_results(m_combination_count);
+    for(int i(0); i < m_runs.size(); i++)
+    {
+        const Run & run(m_runs[i]);
+        const RunResult & result(p_results[i]);
+        combination_results[run.combination].push_back(&result);
+
+        QJsonObject species;
+        for(auto it(result.specie_plant_counts.begin()); it != result.specie_plant_counts.end(); it++)
+            species.insert(QString::number(it->first), it->second);
+
+        QJsonObject run_object;
+        run_object.insert("combination", run.combination);
+        run_object.insert("replicate", run.replicate);
+        run_object.insert("seed", (double) run.configuration.m_seed);
+        run_object.insert("parameters", run.parameters);
+        run_object.insert("elapsed_months", result.elapsed_months);
+        run_object.insert("extinct", result.extinct);
+        run_object.insert("plant_count", result.plant_count);
+        run_object.insert("species", species);
+        run_object.insert("simulation_ms", result.simulation_time);
+        runs.append(run_object);
+    }
+
+    QJsonArray combinations;
+    for(int combination(0); combination < m_combination_count; combination++)
+    {
+        const std::vector<const RunResult*> & results(combination_results[combination]);
+
+        // Specie id --> final plant count of each replicate
+        std::map<int, std::vector<int> > specie_plant_counts;
+        int extinct_count(0);
+        for(const RunResult * result : results)
+        {
+            if(result->extinct)
+                extinct_count++;
+            for(auto it(result->specie_plant_counts.begin()); it != result->specie_plant_counts.end(); it++)
+                specie_plant_counts[it->first].push_back(it->second);
+        }
+
+        QJsonArray species;
+        for(auto it(specie_plant_counts.begin()); it != specie_plant_counts.end(); it++)
+        {
+            std::vector<int> & counts(it->second);
+            counts.resize(results.size(), 0); // Replicates in which the specie was never planted
+
+            double mean(0);
+            for(int count : counts)
+                mean += count;
+            mean /= counts.size();
+
+            double variance(0);
+            for(int count : counts)
+                variance += (count - mean) * (count - mean);
+            variance /= counts.size();
+
+            QJsonObject specie;
+            specie.insert("id", it->first);
+            specie.insert("name", p_specie_table.getBySpecieId(it->first).m_specie_name);
+            specie.insert("mean_plant_count", mean);
+            specie.insert("stddev_plant_count", std::sqrt(variance));
+            species.append(specie);
+        }
+
+        QJsonObject combination_object;
+        combination_object.insert("combination", combination);
+        combination_object.insert("parameters", m_runs[combination * results.size()].parameters);
+        combination_object.insert("replicates", (int) results.size());
+        combination_object.insert("extinct_replicates", extinct_count);
+        combination_object.insert("species", species);
+        combinations.append(combination_object);
+    }
+
+    QJsonObject aggregated;
+    aggregated.insert("combinations", combinations);
+    aggregated.insert("runs", runs);
+    return aggregated;
+}
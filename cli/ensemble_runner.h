@@ -0,0 +1,57 @@
+#ifndef ENSEMBLE_RUNNER_H
+#define ENSEMBLE_RUNNER_H
+
+#include <vector>
+#include <memory>
+#include <QString>
+#include <QJsonObject>
+#include "../simulator/core/simulation_configuration.h"
+
+class SpecieTable;
+
+/**
+ * Runs many simulations concurrently within a single process. The specie table is loaded once and shared
+ * by all simulations. Each simulation runs single threaded as one task of a common thread pool, so all
+ * cores are kept busy without oversubscription.
+ *
+ * Sweep definition (JSON):
+ *  { "base": { <configuration, see ConfigurationReader> },
+ *    "sweep": { "<configuration key>": [<value>, ...], ... },
+ *    "replicates": <simulations per parameter combination> }
+ *
+ * A simulation is run for every combination of the swept values (cartesian product), as many times
+ * as there are replicates. A simulation stops early once every specie is extinct.
+ */
+class EnsembleRunner
+{
+public:
+    EnsembleRunner(const QString & p_sweep_filename); // Throws ConfigurationReader::InvalidConfigurationException
+
+    int getRunCount() const;
+    QJsonObject run(int p_thread_count); // Aggregated results. 0 --> One thread per core
+
+private:
+    struct Run{
+        int combination; // Index of the parameter combination
+        int replicate;
+        QJsonObject parameters; // Swept values
+        SimulationConfiguration configuration;
+    };
+
+    struct RunResult{
+        int elapsed_months;
+        bool extinct;
+        int plant_count;
+        std::map<int, int> specie_plant_counts;
+        qint64 simulation_time; // ms
+    };
+
+    RunResult run_simulation(const Run & p_run, std::shared_ptr<const SpecieTable> p_specie_table) const;
+    QJsonObject aggregate(const std::vector<RunResult> & p_results, const SpecieTable & p_specie_table) const;
+
+    std::shared_ptr<const SpecieTable> m_specie_table;
+    std::vector<Run> m_runs;
+    int m_combination_count;
+};
+
+#endif // ENSEMBLE_RUNNER_H
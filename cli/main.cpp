@@ -0,0 +1,246 @@
+/**
+ * Headless simulator: runs a simulation described by a configuration file (or an ensemble of simulations
+ * described by a sweep definition) at full speed and writes the timings and results as JSON. Only depends
+ * on QtCore: no display connection is ever made.
+ */
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+#include "configuration_reader.h"
+#include "ensemble_runner.h"
+#include "../simulator/core/simulator_manager.h"
+#include "../simulator/plants/specie.h"
+#include "../utils/trace_recorder.h"
+#include "../utils/tracker_writer.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+#define MONTHS_PER_YEAR 12
+
+bool write_results(const QJsonObject & p_results, const QString & p_output_file)
+{
+    QByteArray json(QJsonDocument(p_results).toJson());
+    if(p_output_file.isEmpty())
+    {
+        std::cout << json.constData();
+        return true;
+    }
+
+    QFile output(p_output_file);
+    if(!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        std::cerr << "Unable to write results to " << p_output_file.toStdString() << std::endl;
+        return false;
+    }
+    output.write(json);
+    return true;
+}
+
+bool write_trace(const QString & p_trace_file)
+{
+    if(p_trace_file.isEmpty())
+        return true;
+
+    TraceRecorder::stop();
+    if(!TraceRecorder::write(p_trace_file.toStdString()))
+    {
+        std::cerr << "Unable to write the trace to " << p_trace_file.toStdString() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+QJsonObject month_profile_to_json(const SimulationProfiler::MonthProfile & p_profile)
+{
+    QJsonObject phases, counters, lock_waits;
+    for(int i(0); i < SimulationProfiler::_N_PHASES; i++)
+        phases.insert(SimulationProfiler::getPhaseName((SimulationProfiler::Phase) i), p_profile.phase_times[i]);
+    for(int i(0); i < SimulationProfiler::_N_COUNTERS; i++)
+        counters.insert(SimulationProfiler::getCounterName((SimulationProfiler::Counter) i), (qint64) p_profile.counters[i]);
+    for(int i(0); i < SimulationProfiler::_N_LOCKS; i++)
+        lock_waits.insert(SimulationProfiler::getLockName((SimulationProfiler::Lock) i), p_profile.lock_wait_times[i]);
+
+    QJsonObject profile;
+    profile.insert("month", p_profile.month);
+    profile.insert("total_ms", p_profile.total_time);
+    profile.insert("phases_ms", phases);
+    profile.insert("counters", counters);
+    profile.insert("lock_waits_ms", lock_waits);
+    return profile;
+}
+
+int run_ensemble(const QString & p_sweep_file, int p_thread_count, const QString & p_output_file)
+{
+    try
+    {
+        EnsembleRunner ensemble_runner(p_sweep_file);
+        std::cerr << "Running " << ensemble_runner.getRunCount() << " simulations..." << std::endl;
+
+        auto start(Clock::now());
+        QJsonObject results(ensemble_runner.run(p_thread_count));
+        results.insert("sweep", p_sweep_file);
+        results.insert("ensemble_ms", (qint64) std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+
+        return write_results(results, p_output_file) ? 0 : 1;
+    }
+    catch(const ConfigurationReader::InvalidConfigurationException & e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("EcoSimCLI");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs an EcoSimulator simulation without any user interface.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("configuration", "Simulation configuration file (.json or .ini), or sweep definition (.json) in ensemble mode.");
+    QCommandLineOption output_option(QStringList() << "o" << "output", "Results file (JSON). Printed on the standard output if omitted.", "file");
+    QCommandLineOption threads_option(QStringList() << "t" << "threads", "Overrides the configured thread count (0 --> one per core).", "count");
+    QCommandLineOption ensemble_option(QStringList() << "e" << "ensemble", "Runs all the simulations of a sweep definition concurrently (see cli/ensemble_runner.h).");
+    QCommandLineOption statistical_snapshot_option(QStringList() << "s" << "statistical-snapshot", "Generates a statistical snapshot once the simulation completes.");
+    QCommandLineOption yearly_snapshots_option(QStringList() << "y" << "yearly-statistical-snapshots",
+                                               "Generates an approximate statistical snapshot every simulated year from at most <budget> plants per specie.", "budget");
+    QCommandLineOption profile_option(QStringList() << "p" << "profile", "Records the time spent in each phase of every month, event counts and lock waits.");
+    parser.addOption(output_option);
+    parser.addOption(threads_option);
+    parser.addOption(statistical_snapshot_option);
+    parser.addOption(yearly_snapshots_option);
+    parser.addOption(ensemble_option);
+    QCommandLineOption trace_option(QStringList() << "trace", "Records a timeline of every thread, viewable in chrome://tracing or ui.perfetto.dev.", "file");
+    QCommandLineOption analysis_results_option(QStringList() << "keep-analysis-results",
+                                               "Debug: keeps the statistical snapshot results handed to the tracker in this directory.", "directory");
+    QCommandLineOption results_database_option(QStringList() << "results-database",
+                                               "The tracker's results database, switched to write-ahead logging before the first write.", "file");
+    parser.addOption(profile_option);
+    parser.addOption(trace_option);
+    parser.addOption(analysis_results_option);
+    parser.addOption(results_database_option);
+    parser.process(app);
+
+    if(parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    if(parser.isSet(trace_option))
+    {
+        TraceRecorder::start();
+        TraceRecorder::setThreadName("main");
+    }
+    if(parser.isSet(analysis_results_option))
+        TrackerWriter::instance().setResultsDirectory(parser.value(analysis_results_option));
+    if(parser.isSet(results_database_option))
+        TrackerWriter::instance().setDatabaseFile(parser.value(results_database_option));
+
+    QString configuration_file(parser.positionalArguments().at(0));
+    if(parser.isSet(ensemble_option))
+    {
+        int status(run_ensemble(configuration_file, parser.isSet(threads_option) ? parser.value(threads_option).toInt() : 0, parser.value(output_option)));
+        return write_trace(parser.value(trace_option)) ? status : 1;
+    }
+
+    std::shared_ptr<const SpecieTable> specie_table(SpecieTable::load());
+    SimulationConfiguration configuration;
+    try
+    {
+        configuration = ConfigurationReader::read(configuration_file, *specie_table);
+    }
+    catch(const ConfigurationReader::InvalidConfigurationException & e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if(parser.isSet(threads_option))
+        configuration.m_thread_count = parser.value(threads_option).toInt();
+
+    SimulatorManager simulator_manager(specie_table);
+    simulator_manager.getProfiler().setEnabled(parser.isSet(profile_option));
+
+    auto start(Clock::now());
+    simulator_manager.setConfiguration(configuration);
+    auto setup_time(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+
+    QJsonArray monthly_times, monthly_plant_counts, monthly_profiles;
+    qint64 yearly_snapshots_time(0);
+    while(simulator_manager.getElapsedMonths() < configuration.m_duration)
+    {
+        auto month_start(Clock::now());
+        simulator_manager.trigger();
+        monthly_times.append((qint64) std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - month_start).count());
+        monthly_plant_counts.append(simulator_manager.getPlantCount());
+        if(parser.isSet(profile_option))
+            monthly_profiles.append(month_profile_to_json(simulator_manager.getProfiler().getLastMonth()));
+
+        if(simulator_manager.getElapsedMonths() % MONTHS_PER_YEAR == 0)
+        {
+            std::cerr << "Year " << simulator_manager.getElapsedMonths()/MONTHS_PER_YEAR << " / " << configuration.m_duration/MONTHS_PER_YEAR
+                      << " (" << simulator_manager.getPlantCount() << " plants)" << std::endl;
+            if(parser.isSet(yearly_snapshots_option))
+            {
+                auto snapshot_start(Clock::now());
+                simulator_manager.generateStatisticalSnapshot(std::max(1, parser.value(yearly_snapshots_option).toInt()));
+                yearly_snapshots_time += std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - snapshot_start).count();
+            }
+        }
+    }
+    auto simulation_time(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+
+    qint64 statistical_snapshot_time(0);
+    if(parser.isSet(statistical_snapshot_option))
+    {
+        auto snapshot_start(Clock::now());
+        simulator_manager.generateStatisticalSnapshot();
+        TrackerWriter::instance().flush();
+        statistical_snapshot_time = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - snapshot_start).count();
+    }
+
+    /***********
+     * RESULTS *
+     ***********/
+    QJsonObject timing;
+    timing.insert("setup_ms", (qint64) setup_time);
+    timing.insert("simulation_ms", (qint64) simulation_time);
+    timing.insert("average_month_ms", ((double) simulation_time) / configuration.m_duration);
+    timing.insert("monthly_us", monthly_times);
+    if(parser.isSet(statistical_snapshot_option))
+        timing.insert("statistical_snapshot_ms", statistical_snapshot_time);
+    if(parser.isSet(yearly_snapshots_option))
+        timing.insert("yearly_statistical_snapshots_ms", yearly_snapshots_time); // Included in simulation_ms
+
+    QJsonArray species;
+    std::map<int, int> specie_plant_counts(simulator_manager.getSpeciePlantCounts());
+    for(auto it(specie_plant_counts.begin()); it != specie_plant_counts.end(); it++)
+    {
+        QJsonObject specie;
+        specie.insert("id", it->first);
+        specie.insert("name", simulator_manager.getSpecieTable().getBySpecieId(it->first).m_specie_name);
+        specie.insert("plant_count", it->second);
+        species.append(specie);
+    }
+
+    QJsonObject results;
+    results.insert("configuration", configuration_file);
+    results.insert("seed", (double) configuration.m_seed);
+    results.insert("elapsed_months", simulator_manager.getElapsedMonths());
+    results.insert("plant_count", simulator_manager.getPlantCount());
+    results.insert("monthly_plant_count", monthly_plant_counts);
+    results.insert("species", species);
+    results.insert("timing", timing);
+    if(parser.isSet(profile_option))
+        results.insert("profile", monthly_profiles);
+
+    TrackerWriter::instance().flush(); // Yearly snapshots
+    bool trace_written(write_trace(parser.value(trace_option)));
+    return write_results(results, parser.value(output_option)) && trace_written ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+#include "disc_rasterizer.h"
+#include <math.h>
+#include <algorithm>
+
+namespace {
+    long long floor_div(long long p_numerator, long long p_denominator) // p_denominator > 0
+    {
+        long long quotient(p_numerator / p_denominator);
+        return (p_numerator % p_denominator < 0) ? quotient - 1 : quotient;
+    }
+
+    long long integer_sqrt(long long p_value) // Largest root with root * root <= p_value
+    {
+        long long root(std::sqrt((double) p_value));
+        while(root * root > p_value)
+            root--;
+        while((root+1) * (root+1) <= p_value)
+            root++;
+        return root;
+    }
+}
+
+/*************
+ * FOOTPRINT *
+ *************/
+Footprint::Footprint() :
+    m_world_center(0,0), m_squared_distance_bound(0), m_center_cell_only(false), m_cell_width(1), m_cell_height(1),
+    m_horizontal_cell_count(0), m_vertical_cell_count(0), m_x_begin(0), m_x_end(0)
+{
+
+}
+
+Footprint::Footprint(QPoint p_world_center, long long p_squared_distance_bound, int p_cell_width, int p_cell_height,
+                     int p_horizontal_cell_count, int p_vertical_cell_count) :
+    m_world_center(p_world_center), m_squared_distance_bound(p_squared_distance_bound), m_center_cell_only(false),
+    m_cell_width(p_cell_width), m_cell_height(p_cell_height), m_horizontal_cell_count(p_horizontal_cell_count),
+    m_vertical_cell_count(p_vertical_cell_count), m_x_begin(0), m_x_end(0)
+{
+    // The center of the cell containing the disc center is the nearest: if it is not covered, no other is
+    int center_cell_x(floor_div(p_world_center.x(), p_cell_width));
+    int center_cell_y(floor_div(p_world_center.y(), p_cell_height));
+    long long diff_x(((long long) center_cell_x * p_cell_width) + p_cell_width/2 - p_world_center.x());
+    long long diff_y(((long long) center_cell_y * p_cell_height) + p_cell_height/2 - p_world_center.y());
+
+    if(diff_x * diff_x + diff_y * diff_y < p_squared_distance_bound)
+    {
+        covered_range(p_world_center.x(), integer_sqrt(p_squared_distance_bound - 1), p_cell_width, p_horizontal_cell_count, m_x_begin, m_x_end);
+    }
+    else
+    {
+        m_center_cell_only = true;
+        m_x_begin = std::max(0, center_cell_x);
+        m_x_end = std::min(p_horizontal_cell_count, center_cell_x + 1);
+    }
+    m_x_end = std::max(m_x_begin, m_x_end); // Disc outside of the grid
+}
+
+Footprint::const_iterator Footprint::begin() const
+{
+    return const_iterator(this, m_x_begin);
+}
+
+Footprint::const_iterator Footprint::end() const
+{
+    return const_iterator(this, m_x_end);
+}
+
+bool Footprint::operator==(const Footprint & other) const
+{
+    return m_x_begin == other.m_x_begin && m_x_end == other.m_x_end && m_world_center == other.m_world_center &&
+            m_squared_distance_bound == other.m_squared_distance_bound;
+}
+
+bool Footprint::operator!=(const Footprint & other) const
+{
+    return !(*this == other);
+}
+
+bool Footprint::getSpan(int p_x, CellSpan & p_span) const
+{
+    if(p_x < m_x_begin || p_x >= m_x_end)
+        return false;
+
+    p_span.x = p_x;
+    if(m_center_cell_only)
+    {
+        int center_cell_y(floor_div(m_world_center.y(), m_cell_height));
+        p_span.y_begin = std::max(0, center_cell_y);
+        p_span.y_end = std::min(m_vertical_cell_count, center_cell_y + 1);
+    }
+    else
+    {
+        long long diff_x(((long long) p_x * m_cell_width) + m_cell_width/2 - m_world_center.x());
+        long long squared_reach_y(m_squared_distance_bound - 1 - diff_x * diff_x);
+        if(squared_reach_y < 0)
+            return false;
+        covered_range(m_world_center.y(), integer_sqrt(squared_reach_y), m_cell_height, m_vertical_cell_count, p_span.y_begin, p_span.y_end);
+    }
+    return p_span.y_begin < p_span.y_end;
+}
+
+void Footprint::covered_range(int p_center, long long p_reach, int p_cell_size, int p_cell_count, int & p_begin, int & p_end)
+{
+    long long first(-floor_div(-((long long) p_center - p_cell_size/2 - p_reach), p_cell_size)); // Ceiled
+    long long last(floor_div((long long) p_center - p_cell_size/2 + p_reach, p_cell_size));
+    p_begin = std::max(0LL, first);
+    p_end = std::min((long long) p_cell_count, last + 1);
+}
+
+Footprint::const_iterator::const_iterator(const Footprint * p_footprint, int p_x) :
+    m_footprint(p_footprint), m_x(p_x), m_span()
+{
+    skip_uncovered();
+}
+
+CellSpan Footprint::const_iterator::operator*() const
+{
+    return m_span;
+}
+
+Footprint::const_iterator & Footprint::const_iterator::operator++()
+{
+    m_x++;
+    skip_uncovered();
+    return *this;
+}
+
+bool Footprint::const_iterator::operator!=(const const_iterator & other) const
+{
+    return m_x != other.m_x;
+}
+
+void Footprint::const_iterator::skip_uncovered()
+{
+    while(m_x < m_footprint->m_x_end && !m_footprint->getSpan(m_x, m_span))
+        m_x++;
+}
+
+/*******************
+ * DISC RASTERIZER *
+ *******************/
+DiscRasterizer::DiscRasterizer(int cell_width, int cell_height, int n_horizontal_cells, int n_vertical_cells) :
+    m_cell_width(cell_width), m_cell_height(cell_height), m_horizontal_cell_count(n_horizontal_cells),
+    m_vertical_cell_count(n_vertical_cells)
+{
+
+}
+
+Footprint DiscRasterizer::getFootprint(QPoint p_world_center, float p_radius) const
+{
+    // Smallest integer n for which sqrt(n) < p_radius fails, compared as getPoints does: covered <=> squared distance < n
+    long long squared_distance_bound(0);
+    if(p_radius > 0)
+    {
+        squared_distance_bound = std::ceil(((double) p_radius) * p_radius);
+        while(squared_distance_bound > 0 && !(std::sqrt((double) (squared_distance_bound-1)) < p_radius))
+            squared_distance_bound--;
+        while(std::sqrt((double) squared_distance_bound) < p_radius)
+            squared_distance_bound++;
+    }
+
+    return Footprint(p_world_center, squared_distance_bound, m_cell_width, m_cell_height, m_horizontal_cell_count, m_vertical_cell_count);
+}
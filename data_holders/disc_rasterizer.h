@@ -0,0 +1,101 @@
+#ifndef DISC_RASTERIZER_H
+#define DISC_RASTERIZER_H
+
+#include <algorithm>
+#include <QPoint>
+
+/**
+ * Run of contiguous cells in hashmap space: all cells [y_begin, y_end) of column x.
+ * Columns are the contiguous axis of the SpatialGrid (indexed by x * rows + y).
+ */
+struct CellSpan{
+    int x;
+    int y_begin;
+    int y_end;
+};
+
+/**
+ * Cells covered by a disc, clipped to the grid. Each column's span is solved when reached (one integer square root):
+ * no stencil to cache and iterating does not allocate.
+ */
+class Footprint {
+public:
+    class const_iterator {
+    public:
+        const_iterator(const Footprint * p_footprint, int p_x);
+        CellSpan operator*() const;
+        const_iterator & operator++();
+        bool operator!=(const const_iterator & other) const;
+
+    private:
+        void skip_uncovered();
+
+        const Footprint * m_footprint;
+        int m_x;
+        CellSpan m_span;
+    };
+
+    Footprint(); // Empty
+    Footprint(QPoint p_world_center, long long p_squared_distance_bound, int p_cell_width, int p_cell_height,
+              int p_horizontal_cell_count, int p_vertical_cell_count);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    bool operator==(const Footprint & other) const;
+    bool operator!=(const Footprint & other) const;
+
+    // Clipped span of the given column, false if the footprint does not cover it
+    bool getSpan(int p_x, CellSpan & p_span) const;
+
+    // Calls p_function for each span of cells covered by this footprint but not by p_other
+    template <class F> void forEachSpanNotIn(const Footprint & p_other, F p_function) const
+    {
+        for(const CellSpan span : *this)
+        {
+            CellSpan other_span;
+            if(!p_other.getSpan(span.x, other_span))
+            {
+                p_function(span);
+                continue;
+            }
+
+            CellSpan remainder(span);
+            remainder.y_end = std::min(span.y_end, other_span.y_begin);
+            if(remainder.y_begin < remainder.y_end)
+                p_function(remainder);
+
+            remainder.y_begin = std::max(span.y_begin, other_span.y_end);
+            remainder.y_end = span.y_end;
+            if(remainder.y_begin < remainder.y_end)
+                p_function(remainder);
+        }
+    }
+
+private:
+    // Cells [p_begin, p_end) whose center coordinate c satisfies |c - p_center| <= p_reach
+    static void covered_range(int p_center, long long p_reach, int p_cell_size, int p_cell_count, int & p_begin, int & p_end);
+
+    QPoint m_world_center;
+    long long m_squared_distance_bound; // A cell is covered if its squared center distance is below
+    bool m_center_cell_only; // No cell center within the disc
+    int m_cell_width, m_cell_height, m_horizontal_cell_count, m_vertical_cell_count;
+    int m_x_begin, m_x_end; // Covered columns, clipped
+};
+
+/**
+ * Rasterizes discs into cell spans with the rule of SpatialGrid::getPoints: a cell is covered if its center lies
+ * within the disc and, if no cell center does, the cell containing the disc center is. Center distances are integers,
+ * so the float radius is turned into an exact bound on the squared distance and the coverage is the same cell for cell.
+ */
+class DiscRasterizer {
+public:
+    DiscRasterizer(int cell_width, int cell_height, int n_horizontal_cells, int n_vertical_cells);
+
+    Footprint getFootprint(QPoint p_world_center, float p_radius) const;
+
+private:
+    int m_cell_width, m_cell_height, m_horizontal_cell_count, m_vertical_cell_count;
+};
+
+#endif // DISC_RASTERIZER_H
@@ -7,10 +7,9 @@
 /*********************
  * ILLUMINATION CELL *
  *********************/
-int IlluminationCell::_total_available_illumination = 0;
-IlluminationCell::IlluminationCell() : id_to_height()
+IlluminationCell::IlluminationCell() : m_occupants(), m_max_height(-1), m_max_height_id(-1)
 {
-    reset();
+
 }
 
 IlluminationCell::~IlluminationCell()
@@ -18,60 +17,94 @@ IlluminationCell::~IlluminationCell()
 
 }
 
-void IlluminationCell::update(int p_id, float p_height)
+void IlluminationCell::add(int p_id, const std::vector<float> & p_heights)
 {
-    id_to_height[p_id] = p_height;
-    reset();
+    if(find(p_id) != -1)
+        return;
+
+    m_occupants.push_back(p_id);
+    if(m_max_height_id == -1 || is_taller(p_id, p_heights[p_id]))
+    {
+        m_max_height_id = p_id;
+        m_max_height = p_heights[p_id];
+    }
 }
 
-void IlluminationCell::reset()
+void IlluminationCell::setHeight(int p_id, const std::vector<float> & p_heights)
 {
-    m_max_height = -1;
-    m_max_height_id = -1;
+    float height(p_heights[p_id]);
+    if(m_max_height_id == p_id)
+    {
+        if(height >= m_max_height)
+            m_max_height = height;
+        else // The tallest plant shrunk
+            rescan(p_heights);
+    }
+    else if(m_max_height_id != -1 && is_taller(p_id, height) && find(p_id) != -1)
+    {
+        m_max_height_id = p_id;
+        m_max_height = height;
+    }
 }
 
-int IlluminationCell::getIllumination(int p_id, int p_height)
+int IlluminationCell::getIllumination(int p_id, int p_height, int p_available_illumination) const
 {
-    if(m_max_height_id == -1) // Refresh required
-        refresh();
-
     if(p_height > m_max_height || m_max_height_id == p_id) // Plants that don't block shade are not stored. Just check if they are above the first shade blocking plant
-        return IlluminationCell::_total_available_illumination;
+        return p_available_illumination;
 
     return 0;
 }
 
-#include <QDebug>
-void IlluminationCell::refresh()
+void IlluminationCell::remove(int p_id, const std::vector<float> & p_heights)
 {
-    int i(0);
-    for(auto it(id_to_height.begin()); it != id_to_height.end(); it++, i++)
+    int idx(find(p_id));
+    if(idx == -1)
+        return;
+
+    m_occupants.swapRemove(idx);
+    if(m_max_height_id == p_id)
+        rescan(p_heights);
+}
+
+int IlluminationCell::getRenderingIllumination(int p_available_illumination) const
+{
+    return (!m_occupants.empty() ? 0 : p_available_illumination);
+}
+
+int IlluminationCell::find(int p_id) const
+{
+    for(int i(0); i < m_occupants.size(); i++)
     {
-        if(i == 0 || it->second > m_max_height)
-        {
-            m_max_height_id = it->first;
-            m_max_height = it->second;
-        }
+        if(m_occupants[i] == p_id)
+            return i;
     }
+    return -1;
 }
 
-void IlluminationCell::remove(int p_id)
+// Ties are resolved towards the lowest id
+bool IlluminationCell::is_taller(int p_id, float p_height) const
 {
-    id_to_height.erase(p_id);
-    reset();
+    return p_height > m_max_height || (p_height == m_max_height && p_id < m_max_height_id);
 }
 
-int IlluminationCell::getRenderingIllumination() const
+void IlluminationCell::rescan(const std::vector<float> & p_heights)
 {
-    return (id_to_height.size() > 0 ? 0 : IlluminationCell::_total_available_illumination);
+    m_max_height = -1;
+    m_max_height_id = -1;
+    for(int id : m_occupants)
+    {
+        if(m_max_height_id == -1 || is_taller(id, p_heights[id]))
+        {
+            m_max_height_id = id;
+            m_max_height = p_heights[id];
+        }
+    }
 }
 
 /**********************
  * SOIL HUMIDITY CELL *
  **********************/
-int SoilHumidityCell::_total_available_humidity = 0;
-int SoilHumidityCell::id_incrementor = 0;
-SoilHumidityCell::SoilHumidityCell() : m_requests(), m_grants(), m_refresh_required(true), m_unique_id(id_incrementor++)
+SoilHumidityCell::SoilHumidityCell() : m_requestees()
 {
 
 }
@@ -81,69 +114,51 @@ SoilHumidityCell::~SoilHumidityCell()
 
 }
 
-void SoilHumidityCell::reset()
+void SoilHumidityCell::add(int p_id, const std::vector<ResourceUsageRequest> & p_requests)
 {
-    m_refresh_required = true;
-    m_grants.clear();
-}
+    if(find(p_id) != -1)
+        return;
 
-int SoilHumidityCell::getGrantedHumidity(int p_id)
-{
-    if(m_refresh_required) // Refresh requited
-        refresh();
-
-    auto it(m_grants.find(p_id));
-
-    if(it != m_grants.end())
-        return it->second;
-
-    return 0;
+    m_requestees.push_back(p_id);
+    sort_requestee(m_requestees.size()-1, p_requests);
 }
 
-void SoilHumidityCell::update(int p_id, float p_roots_size,int p_minimum_humidity)
+void SoilHumidityCell::setRequest(int p_id, const std::vector<ResourceUsageRequest> & p_requests)
 {
-    ResourceUsageRequest request(p_minimum_humidity, p_roots_size, p_id);
-    auto it(m_requests.find(p_id));
-    if(it != m_requests.end())
-        it->second = request;
-    else
-        m_requests.emplace(p_id, request);
-
-    m_refresh_required = true;
+    int idx(find(p_id));
+    if(idx != -1)
+        sort_requestee(idx, p_requests);
 }
 
 void SoilHumidityCell::remove(int p_id)
 {
-    m_requests.erase(p_id);
-
-    m_refresh_required = true;
+    int idx(find(p_id));
+    if(idx != -1)
+        m_requestees.erase(idx);
 }
 
-void SoilHumidityCell::refresh()
+/**
+ * Splits the available humidity between the requestees and adds each grant to the requestee's total
+ * (indexed by plant id).
+ */
+void SoilHumidityCell::grant(std::vector<int> & p_granted_totals, int p_available_humidity, const std::vector<ResourceUsageRequest> & p_requests) const
 {
-    m_grants.clear();
-    int humidity_available( SoilHumidityCell::_total_available_humidity );
+    int humidity_available( p_available_humidity );
 
     if(humidity_available >= 300) //  No splitting necessary --> Water plentiful
     {
-        for(auto it(m_requests.begin()); it != m_requests.end(); it++)
-        {
-            m_grants.emplace(it->second.requestee_id, humidity_available);
-        }
+        for(int id : m_requestees)
+            p_granted_totals[id] += humidity_available;
     }
     else
     {
-        std::vector<ResourceUsageRequest> requests;
-        int n_requests(0);
         float remaining_total_vigor(.0f);
         int total_requested_humidity(0);
 
-        for(auto it(m_requests.begin()); it != m_requests.end(); it++)
+        for(int id : m_requestees)
         {
-            requests.push_back(it->second);
-            remaining_total_vigor += it->second.size;
-            total_requested_humidity += it->second.requested_amount;
-            n_requests++;
+            remaining_total_vigor += p_requests[id].size;
+            total_requested_humidity += p_requests[id].requested_amount;
         }
 
         /*
@@ -152,11 +167,8 @@ void SoilHumidityCell::refresh()
         if(total_requested_humidity < humidity_available)
         {
             int overflow(humidity_available-total_requested_humidity);
-            for(auto it(requests.begin()); it != requests.end(); it++)
-            {
-                int granted_amount (it->requested_amount + overflow);
-                m_grants.emplace(it->requestee_id,granted_amount );
-            }
+            for(int id : m_requestees)
+                p_granted_totals[id] += p_requests[id].requested_amount + overflow;
         }
         /*
          * Less resources than necessary: Split based on vigor as follows:
@@ -165,53 +177,53 @@ void SoilHumidityCell::refresh()
          */
         else
         {
-            // First sort the requests based on vigor
-            std::sort(requests.begin(), requests.end(), [](const ResourceUsageRequest & lhs, const ResourceUsageRequest & rhs) {return lhs.size < rhs.size;});
-            // Iterate in reverse order
-            for(auto it(requests.rbegin()); it != requests.rend(); it++)
+            for(int id : m_requestees)
             {
-                float vigor( it->size / remaining_total_vigor );
-                int granted_amount ( std::min(it->requested_amount, (int)(vigor * humidity_available) ) );
+                const ResourceUsageRequest & request(p_requests[id]);
+                float vigor( request.size / remaining_total_vigor );
+                int granted_amount ( std::min(request.requested_amount, (int)(vigor * humidity_available) ) );
 
-                m_grants.emplace( it->requestee_id, granted_amount );
+                p_granted_totals[id] += granted_amount;
 
-                remaining_total_vigor -= it->size;
+                remaining_total_vigor -= request.size;
                 humidity_available -= granted_amount ;
             }
         }
     }
-    m_refresh_required = false;
-}
-
-int SoilHumidityCell::getRenderingHumidity() const
-{
-    return (m_grants.size() > 0 ? 0 : SoilHumidityCell::_total_available_humidity);
 }
 
-/********************
- * TEMPERATURE CELL *
- ********************/
-int TemperatureCell::_temperature = 0;
-TemperatureCell::TemperatureCell()
+int SoilHumidityCell::getRenderingHumidity(int p_available_humidity) const
 {
-
+    return (!m_requestees.empty() ? 0 : p_available_humidity);
 }
 
-TemperatureCell::~TemperatureCell()
+int SoilHumidityCell::find(int p_id) const
 {
-
+    for(int i(0); i < m_requestees.size(); i++)
+    {
+        if(m_requestees[i] == p_id)
+            return i;
+    }
+    return -1;
 }
 
-int TemperatureCell::getTemperature() const
+// Moves the requestee to its place, the others being sorted
+void SoilHumidityCell::sort_requestee(int p_idx, const std::vector<ResourceUsageRequest> & p_requests)
 {
-    return _temperature;
+    auto more_vigorous([&p_requests](int lhs, int rhs) {
+        return p_requests[lhs].size > p_requests[rhs].size || (p_requests[lhs].size == p_requests[rhs].size && lhs < rhs);
+    });
+    for(; p_idx > 0 && more_vigorous(m_requestees[p_idx], m_requestees[p_idx-1]); p_idx--)
+        std::swap(m_requestees[p_idx-1], m_requestees[p_idx]);
+    for(; p_idx < m_requestees.size()-1 && more_vigorous(m_requestees[p_idx+1], m_requestees[p_idx]); p_idx++)
+        std::swap(m_requestees[p_idx+1], m_requestees[p_idx]);
 }
 
 /************************************
  * ENVIRONMENT SPATIAL HASHMAP CELL *
  ************************************/
 EnvironmentSpatialHashMapCell::EnvironmentSpatialHashMapCell() :
-    illumination_cell(), soil_humidity_cell(), temp_cell()
+    illumination_cell(), soil_humidity_cell()
 {
 
 }
@@ -228,21 +240,13 @@ EnvironmentSpatialHashMapCell::~EnvironmentSpatialHashMapCell()
  * ENVIRONMENT SPATIAL HASHMAP *
  *******************************/
 EnvironmentSpatialHashMap::EnvironmentSpatialHashMap(int area_width, int area_height) :
-    SpatialHashMap<EnvironmentSpatialHashMapCell>(SPATIAL_HASHMAP_CELL_WIDTH, SPATIAL_HASHMAP_CELL_HEIGHT,
+    SpatialGrid<EnvironmentSpatialHashMapCell>(SPATIAL_HASHMAP_CELL_WIDTH, SPATIAL_HASHMAP_CELL_HEIGHT,
                                                  std::ceil(((float)area_width)/SPATIAL_HASHMAP_CELL_WIDTH),
-                                                 std::ceil(((float)area_height)/SPATIAL_HASHMAP_CELL_HEIGHT))
+                                                 std::ceil(((float)area_height)/SPATIAL_HASHMAP_CELL_HEIGHT)),
+    m_available_illumination(0), m_available_humidity(0), m_temperature(0),
+    m_pending_change_flags(getCellCount(), false), m_first_published_version(0), m_published_version(0), m_published_change_count(0)
 {
-//    for(int x = 0; x < getHorizontalCellCount(); x++)
-//    {
-//        for(int y = 0; y < getVerticalCellCount(); y++)
-//        {
-//            init_cell(QPoint(x,y));
-//            EnvironmentSpatialHashMapCell * cell = get(QPoint(x,y));
-//            cell->soil_humidity_cell = new SoilHumidityCell;
-//            cell->illumination_cell = new IlluminationCell;
-//            cell->temp_cell = new TemperatureCell;
-//        }
-//    }
+
 }
 
 EnvironmentSpatialHashMap::~EnvironmentSpatialHashMap()
@@ -250,34 +254,127 @@ EnvironmentSpatialHashMap::~EnvironmentSpatialHashMap()
 
 }
 
-std::vector<QPoint> EnvironmentSpatialHashMap::getPoints(QPoint p_center, float p_radius) const
+// Every cell free of plants is redrawn when a resource changes
+void EnvironmentSpatialHashMap::setAvailableResources(int p_available_illumination, int p_available_humidity, int p_temperature)
 {
-    return SpatialHashMap<EnvironmentSpatialHashMapCell>::getPoints(p_center, p_radius, true);
+    if(p_available_illumination != m_available_illumination || p_available_humidity != m_available_humidity || p_temperature != m_temperature)
+    {
+        std::lock_guard<std::mutex> lock(m_changes_mutex);
+        invalidate_changed_cells();
+    }
+
+    m_available_humidity = p_available_humidity;
+    m_available_illumination = p_available_illumination;
+    m_temperature = p_temperature;
 }
 
-void EnvironmentSpatialHashMap::setAvailableResources(int p_available_illumination, int p_available_humidity, int p_temperature)
+int EnvironmentSpatialHashMap::getAvailableIllumination() const
+{
+    return m_available_illumination;
+}
+
+int EnvironmentSpatialHashMap::getAvailableHumidity() const
+{
+    return m_available_humidity;
+}
+
+int EnvironmentSpatialHashMap::getTemperature() const
+{
+    return m_temperature;
+}
+
+void EnvironmentSpatialHashMap::clear()
+{
+    SpatialGrid<EnvironmentSpatialHashMapCell>::clear();
+    m_plant_heights.clear();
+    m_plant_requests.clear();
+
+    m_pending_change_flags.assign(getCellCount(), false);
+    m_pending_changes.clear();
+    std::lock_guard<std::mutex> lock(m_changes_mutex);
+    invalidate_changed_cells();
+}
+
+void EnvironmentSpatialHashMap::publishChangedCells()
 {
-    SoilHumidityCell::_total_available_humidity = p_available_humidity;
-    IlluminationCell::_total_available_illumination = p_available_illumination;
-    TemperatureCell::_temperature = p_temperature;
-    resetAllCells();
+    if(m_pending_changes.empty())
+        return;
+
+    for(int cell : m_pending_changes)
+        m_pending_change_flags[cell] = false;
+
+    std::lock_guard<std::mutex> lock(m_changes_mutex);
+    m_published_change_count += m_pending_changes.size();
+    m_published_changes.push_back(std::vector<int>());
+    m_published_changes.back().swap(m_pending_changes);
+    m_published_version++;
+
+    while(m_published_change_count > getCellCount())
+    {
+        m_published_change_count -= m_published_changes.front().size();
+        m_published_changes.pop_front();
+        m_first_published_version++;
+    }
 }
 
-void EnvironmentSpatialHashMap::resetAllCells()
+bool EnvironmentSpatialHashMap::getChangedCells(long & p_version, std::vector<int> & p_cells) const
 {
-    for(auto it(begin()); it != end(); it++)
+    std::lock_guard<std::mutex> lock(m_changes_mutex);
+    bool known(p_version >= m_first_published_version);
+    if(known)
     {
-        it->second.soil_humidity_cell.reset();
-        it->second.illumination_cell.reset();
+        for(int batch(p_version - m_first_published_version); batch < m_published_changes.size(); batch++)
+            p_cells.insert(p_cells.end(), m_published_changes[batch].begin(), m_published_changes[batch].end());
     }
-//    clear();
-//    for(int x = 0; x < getHorizontalCellCount(); x++)
-//    {
-//        for(int y = 0; y < getVerticalCellCount(); y++)
-//        {
-//            EnvironmentSpatialHashMapCell & cell ( this->operator [](QPoint(x,y) ));
-//            cell.soil_humidity_cell.reset();
-//            cell.illumination_cell.reset();
-//        }
-//    }
+    p_version = m_published_version;
+    return known;
+}
+
+void EnvironmentSpatialHashMap::invalidate_changed_cells()
+{
+    m_published_changes.clear();
+    m_published_change_count = 0;
+    m_published_version++;
+    m_first_published_version = m_published_version;
+}
+
+// Only the cells of the canopy are told, and only if the height changed
+int EnvironmentSpatialHashMap::setPlantHeight(int p_id, float p_height, const Footprint & p_canopy)
+{
+    if(p_id >= m_plant_heights.size())
+        m_plant_heights.resize(p_id+1, .0f);
+    if(m_plant_heights[p_id] == p_height)
+        return 0;
+
+    m_plant_heights[p_id] = p_height;
+    int touched_cells(0);
+    for(const CellSpan span : p_canopy)
+        touched_cells += forEachCell(span, [this, p_id](EnvironmentSpatialHashMapCell & cell) { cell.illumination_cell.setHeight(p_id, m_plant_heights); });
+    return touched_cells;
+}
+
+const std::vector<float> & EnvironmentSpatialHashMap::getPlantHeights() const
+{
+    return m_plant_heights;
+}
+
+// Only the cells of the roots are told, and only if the size the requestees are sorted by changed
+int EnvironmentSpatialHashMap::setPlantRequest(int p_id, float p_roots_size, int p_minimum_humidity, const Footprint & p_roots)
+{
+    if(p_id >= m_plant_requests.size())
+        m_plant_requests.resize(p_id+1);
+    bool resized(m_plant_requests[p_id].size != p_roots_size);
+    m_plant_requests[p_id] = ResourceUsageRequest(p_minimum_humidity, p_roots_size, p_id);
+    if(!resized)
+        return 0;
+
+    int touched_cells(0);
+    for(const CellSpan span : p_roots)
+        touched_cells += forEachCell(span, [this, p_id](EnvironmentSpatialHashMapCell & cell) { cell.soil_humidity_cell.setRequest(p_id, m_plant_requests); });
+    return touched_cells;
+}
+
+const std::vector<ResourceUsageRequest> & EnvironmentSpatialHashMap::getPlantRequests() const
+{
+    return m_plant_requests;
 }
@@ -1,29 +1,40 @@
 #ifndef ENVIRONMENT_SPATIAL_HASHMAP_H
 #define ENVIRONMENT_SPATIAL_HASHMAP_H
 
-#include "SpatialHashmap/spatial_hashmap.h"
+#include "spatial_grid.h"
+#include "../utils/small_vector.h"
 #include <math.h>
+#include <map>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
 
 /*********************
  * ILLUMINATION CELL *
  *********************/
+/**
+ * Only holds the ids of the plants shading it: heights are kept per plant by EnvironmentSpatialHashMap. The tallest
+ * occupant is kept up to date as plants come, go and change height, the occupants only being rescanned when the
+ * tallest shrinks or leaves.
+ */
 class IlluminationCell {
 public:
     IlluminationCell();
     ~IlluminationCell();
-    void update(int p_id, float p_height);
-    void reset();
-    int getIllumination(int p_id, int p_height);
-    void remove(int p_id);
-    int getRenderingIllumination() const;
-
-    static int _total_available_illumination;
+    void add(int p_id, const std::vector<float> & p_heights);
+    void setHeight(int p_id, const std::vector<float> & p_heights); // The plant's height changed in p_heights
+    int getIllumination(int p_id, int p_height, int p_available_illumination) const;
+    void remove(int p_id, const std::vector<float> & p_heights);
+    int getRenderingIllumination(int p_available_illumination) const;
 
 private:
-    void refresh();
-    std::map<int, float> id_to_height;
+    int find(int p_id) const;
+    bool is_taller(int p_id, float p_height) const;
+    void rescan(const std::vector<float> & p_heights);
+
+    SmallVector<int, 4> m_occupants;
     float m_max_height;
-    int m_max_height_id;
+    int m_max_height_id; // -1 if empty
 };
 
 /**********************
@@ -34,46 +45,33 @@ struct ResourceUsageRequest{
     float size;
     int requestee_id;
 
+    ResourceUsageRequest() : requested_amount(0), size(.0f), requestee_id(-1) {}
     ResourceUsageRequest(int p_requested_amount, float p_size, int p_requestee_id) :
         requested_amount(p_requested_amount), size(p_size), requestee_id(p_requestee_id) {}
 };
-typedef std::unordered_map<int, ResourceUsageRequest> RequestsMap;
-typedef std::unordered_map<int, int> GrantsMap;
+/**
+ * Only holds the ids of the plants rooted in it: requests are kept per plant by EnvironmentSpatialHashMap. The
+ * requestees stay sorted across months, a plant only being moved when its request changes.
+ */
 class SoilHumidityCell{
 public:
     SoilHumidityCell();
     ~SoilHumidityCell();
-    void reset();
-    int getGrantedHumidity(int p_id);
+    void add(int p_id, const std::vector<ResourceUsageRequest> & p_requests);
+    void setRequest(int p_id, const std::vector<ResourceUsageRequest> & p_requests); // The plant's size changed in p_requests
     void remove(int p_id);
-    void update(int p_id, float p_roots_size,int p_minimum_humidity);
+    void grant(std::vector<int> & p_granted_totals, int p_available_humidity, const std::vector<ResourceUsageRequest> & p_requests) const;
 
-    int getRenderingHumidity() const;
-    static int _total_available_humidity;
+    int getRenderingHumidity(int p_available_humidity) const;
 
 private:
-    void refresh();
-    RequestsMap m_requests;
-    GrantsMap m_grants;
-    bool m_refresh_required;
-    int m_unique_id;
-    static int id_incrementor;
-};
-
-
-/********************
- * TEMPERATURE CELL *
- ********************/
-class TemperatureCell {
-public:
-    TemperatureCell();
-    ~TemperatureCell();
+    int find(int p_id) const;
+    void sort_requestee(int p_idx, const std::vector<ResourceUsageRequest> & p_requests);
 
-    int getTemperature() const;
-
-    static int _temperature;
+    SmallVector<int, 4> m_requestees; // Most vigorous first, ties towards the lowest id
 };
 
+
 /*******************************
  * ENVIRONMENT SPATIAL HASHMAP *
  *******************************/
@@ -81,20 +79,70 @@ class EnvironmentSpatialHashMapCell {
 public:
     IlluminationCell illumination_cell;
     SoilHumidityCell soil_humidity_cell;
-    TemperatureCell temp_cell;
 
     EnvironmentSpatialHashMapCell();
     ~EnvironmentSpatialHashMapCell();
 };
 
-class EnvironmentSpatialHashMap : public SpatialHashMap<EnvironmentSpatialHashMapCell>
+// The terrain is bounded and densely covered: backed by a flat grid rather than a hashmap
+class EnvironmentSpatialHashMap : public SpatialGrid<EnvironmentSpatialHashMapCell>
 {
 public:
     EnvironmentSpatialHashMap(int area_width, int area_height);
     ~EnvironmentSpatialHashMap();
-    std::vector<QPoint> getPoints(QPoint p_center, float p_radius) const;
     void setAvailableResources(int p_available_illumination, int p_available_humidity, int p_temperature );
-    void resetAllCells();
+    int getAvailableIllumination() const;
+    int getAvailableHumidity() const;
+    int getTemperature() const;
+    void clear(); // Cells and plant tables
+
+    // Same as forEachCell, the cells being recorded as changed for the renderers
+    template <class F> int forEachChangedCell(const CellSpan & p_span, F p_function)
+    {
+        int first_cell(index(QPoint(p_span.x, p_span.y_begin)));
+        for(int cell(first_cell); cell < first_cell + (p_span.y_end - p_span.y_begin); cell++)
+        {
+            if(!m_pending_change_flags[cell])
+            {
+                m_pending_change_flags[cell] = true;
+                m_pending_changes.push_back(cell);
+            }
+        }
+        return forEachCell(p_span, p_function);
+    }
+    void publishChangedCells(); // Once the changed cells are up to date
+    /**
+     * Appends the cells changed since p_version was returned, and updates it. Returns false if they are no longer
+     * known and every cell must be considered changed (p_version -1 on the first call).
+     */
+    bool getChangedCells(long & p_version, std::vector<int> & p_cells) const;
+
+    // Per plant tables, indexed by plant id. Plant ids are recycled by the storage so they remain bounded
+    int setPlantHeight(int p_id, float p_height, const Footprint & p_canopy); // Returns the number of cells touched
+    const std::vector<float> & getPlantHeights() const;
+    int setPlantRequest(int p_id, float p_roots_size, int p_minimum_humidity, const Footprint & p_roots); // Returns the number of cells touched
+    const std::vector<ResourceUsageRequest> & getPlantRequests() const;
+
+private:
+    // Resources of the current month, shared by all cells
+    int m_available_illumination;
+    int m_available_humidity;
+    int m_temperature;
+
+    // Change every month for growing plants: kept out of the cells so that only footprint changes touch them
+    std::vector<float> m_plant_heights;
+    std::vector<ResourceUsageRequest> m_plant_requests;
+
+    void invalidate_changed_cells(); // Changes guarded
+
+    std::vector<bool> m_pending_change_flags; // By flat cell index
+    std::vector<int> m_pending_changes;
+    // One batch of changed cells per published version, the oldest dropped once they add up to the cell count
+    mutable std::mutex m_changes_mutex;
+    std::deque<std::vector<int> > m_published_changes;
+    long m_first_published_version; // Version the first batch applies to
+    long m_published_version;
+    int m_published_change_count;
 };
 
 #endif //ENVIRONMENT_SPATIAL_HASHMAP_H
@@ -1,22 +1,23 @@
 #ifndef PLANT_RENDERING_DATA_H
 #define PLANT_RENDERING_DATA_H
 
-#include <QString>
 #include <QPoint>
-#include <QColor>
+#include <QRgb>
 
+/**
+ * Compact record of what is needed to draw a plant. The specie is referenced by its index in the specie table.
+ */
 class PlantRenderingData{
 public:
-    QString name;
     QPoint center_position;
-    const QColor color;
-    float height;
-    float roots_radius;
     float canopy_radius;
+    float roots_radius;
+    QRgb color;
+    unsigned short specie_index;
 
-    PlantRenderingData(QString p_name, const QColor p_color, QPoint p_center_position, float p_height, float p_canopy_width,
-                       float p_roots_size) : name(p_name), color(p_color), center_position(p_center_position), height(p_height),
-        canopy_radius(p_canopy_width/2), roots_radius(p_roots_size) {}
+    PlantRenderingData(int p_specie_index, QRgb p_color, QPoint p_center_position, float p_canopy_width, float p_roots_size) :
+        center_position(p_center_position), canopy_radius(p_canopy_width/2), roots_radius(p_roots_size), color(p_color),
+        specie_index(p_specie_index) {}
 };
 
 #endif // PLANT_RENDERING_DATA_H
@@ -4,25 +4,65 @@
 #include "plant_rendering_data.h"
 
 #include <vector>
-#include <mutex>
+#include <atomic>
 
-struct PlantRenderDataContainer : public std::vector<PlantRenderingData>
+/**
+ * Triple buffer through which the simulation thread publishes plant rendering data to the renderers without
+ * locking. The writer fills the back buffer and publishes it; the reader acquires the latest published frame,
+ * which stays untouched until its next acquisition. One writer thread (simulation) and one reader thread
+ * (render timer) only.
+ */
+class PlantRenderDataContainer
 {
 public:
-    PlantRenderDataContainer() : mutex() {}
+    struct Frame{
+        std::vector<PlantRenderingData> plants;
+        long version;
 
-    void lock() const
+        Frame() : plants(), version(0) {}
+    };
+
+    PlantRenderDataContainer() : m_version(0), m_back(0), m_latest(1), m_front(2) {}
+
+    /**********
+     * WRITER *
+     **********/
+    std::vector<PlantRenderingData> & getBackBuffer()
+    {
+        return m_frames[m_back].plants;
+    }
+
+    void publish()
     {
-        mutex.lock();
+        m_frames[m_back].version = ++m_version;
+        m_back = m_latest.exchange(m_back | _FRESH, std::memory_order_acq_rel) & _INDEX_MASK;
     }
 
-    void unlock() const
+    /**********
+     * READER *
+     **********/
+    const Frame & acquire()
     {
-        mutex.unlock();
+        if(m_latest.load(std::memory_order_acquire) & _FRESH)
+            m_front = m_latest.exchange(m_front, std::memory_order_acq_rel) & _INDEX_MASK;
+        return m_frames[m_front];
+    }
+
+    // Version of the latest published frame. Nothing has changed if it matches the version of the last acquired frame
+    long getVersion() const
+    {
+        return m_version.load();
     }
 
 private:
-    mutable std::mutex mutex;
+    static const int _INDEX_MASK = 3;
+    static const int _FRESH = 4; // Set on the latest index when it has not been acquired yet
+
+    Frame m_frames[3];
+    std::atomic<long> m_version;
+    int m_back; // Writer only
+    std::atomic<int> m_latest;
+    int m_front; // Reader only
 };
 
 #endif // PLANT_RENDERING_DATA_CONTAINER_H
@@ -0,0 +1,141 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <vector>
+#include <algorithm>
+#include <QPoint>
+#include <math.h>
+#include "disc_rasterizer.h"
+
+/**
+ * Dense counterpart of SpatialHashMap for bounded domains where every cell is used. Cells are
+ * stored in a single flat array indexed by x * rows + y and are all initialised on construction.
+ * Exposes the same API as SpatialHashMap.
+ */
+template <class T> class SpatialGrid {
+public:
+    enum Space{
+        _WORLD,
+        _HASHMAP
+    };
+
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    SpatialGrid(int cell_width, int cell_height, int n_horizontal_cells, int n_vertical_cells) :
+        m_cell_width(cell_width), m_cell_height(cell_height),
+        m_horizontal_cell_count(n_horizontal_cells),
+        m_vertical_cell_count(n_vertical_cells),
+        m_cells(n_horizontal_cells * n_vertical_cells),
+        m_rasterizer(cell_width, cell_height, n_horizontal_cells, n_vertical_cells)
+    {
+
+    }
+
+    int getHorizontalCellCount() const { return m_horizontal_cell_count; }
+    int getVerticalCellCount() const { return m_vertical_cell_count; }
+    int getCellWidth() const { return m_cell_width; }
+    int getCellHeight() const { return m_cell_height; }
+    int getCellCount() const { return m_cells.size(); }
+
+    T & getCell(QPoint p_point, Space p_space)
+    {
+        return m_cells[index(p_space == Space::_WORLD ? toHashMapCoordinates(p_point) : p_point)];
+    }
+
+    const T & getCell(QPoint p_point, Space p_space) const
+    {
+        return m_cells[index(p_space == Space::_WORLD ? toHashMapCoordinates(p_point) : p_point)];
+    }
+
+    // Direct access through the flat index
+    T & getCell(int p_index) { return m_cells[p_index]; }
+    const T & getCell(int p_index) const { return m_cells[p_index]; }
+
+    int index(const QPoint & p_hashmap_coord) const
+    {
+        return p_hashmap_coord.x() * m_vertical_cell_count + p_hashmap_coord.y();
+    }
+
+    // All cells within the domain are initialised
+    bool initialised(QPoint p_hashmap_coord) const
+    {
+        return p_hashmap_coord.x() >= 0 && p_hashmap_coord.x() < m_horizontal_cell_count &&
+                p_hashmap_coord.y() >= 0 && p_hashmap_coord.y() < m_vertical_cell_count;
+    }
+
+    bool ws_initialised(QPoint p_world_coord) const
+    {
+        return p_world_coord.x() >= 0 && p_world_coord.y() >= 0 && initialised(toHashMapCoordinates(p_world_coord));
+    }
+
+    /**
+     * Returns the cells (in hashmap space) whose centers lie within the given circle. If p_at_least_one is set
+     * and no cell center lies within the circle, the cell containing the circle center is returned.
+     */
+    std::vector<QPoint> getPoints(QPoint p_center, float p_radius, bool p_at_least_one) const
+    {
+        QPoint min(toHashMapCoordinates(QPoint(std::max(0.0f, p_center.x()-p_radius), std::max(0.0f, p_center.y()-p_radius))));
+        QPoint max(toHashMapCoordinates(QPoint(p_center.x()+p_radius, p_center.y()+p_radius)));
+
+        std::vector<QPoint> ret;
+        for(int x (min.x()); x < std::min(m_horizontal_cell_count, max.x()+1); x++)
+        {
+            for(int y (min.y()); y < std::min(m_vertical_cell_count, max.y()+1); y++)
+            {
+                // Ensure at least the center of the cell is within reach
+                if(sqrt(pow(((x*m_cell_width) + m_cell_width/2) - p_center.x(),2) +
+                      pow(((y*m_cell_height) + m_cell_height/2) - p_center.y(),2)) < p_radius)
+                {
+                    ret.push_back(QPoint(x,y));
+                }
+            }
+        }
+
+        if(ret.size() == 0 && p_at_least_one && ws_initialised(p_center))
+            ret.push_back(toHashMapCoordinates(p_center));
+
+        return ret;
+    }
+
+    /**
+     * Cells (in hashmap space) covered by the given circle, as spans of contiguous flat indices. Exactly the cells of
+     * getPoints with p_at_least_one set. Does not allocate.
+     */
+    Footprint getFootprint(QPoint p_center, float p_radius) const
+    {
+        return m_rasterizer.getFootprint(p_center, p_radius);
+    }
+
+    // Returns the number of cells visited
+    template <class F> int forEachCell(const CellSpan & p_span, F p_function)
+    {
+        T * cell(&m_cells[index(QPoint(p_span.x, p_span.y_begin))]);
+        for(int y(p_span.y_begin); y < p_span.y_end; y++, cell++)
+            p_function(*cell);
+        return p_span.y_end - p_span.y_begin;
+    }
+
+    iterator begin() { return m_cells.begin(); }
+    iterator end() { return m_cells.end(); }
+    const_iterator cbegin() const { return m_cells.cbegin(); }
+    const_iterator cend() const { return m_cells.cend(); }
+
+    // Resets all cells to their initial state
+    void clear()
+    {
+        m_cells.assign(m_cells.size(), T());
+    }
+
+    QPoint toHashMapCoordinates(const QPoint & p_world_coord) const
+    {
+        return QPoint(p_world_coord.x() / m_cell_width, p_world_coord.y() / m_cell_height);
+    }
+
+protected:
+    int m_cell_width, m_cell_height, m_horizontal_cell_count, m_vertical_cell_count;
+    std::vector<T> m_cells;
+    DiscRasterizer m_rasterizer;
+};
+
+#endif // SPATIAL_GRID_H
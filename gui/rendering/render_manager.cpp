@@ -1,12 +1,13 @@
 #include "render_manager.h"
 #include <QDebug>
+#include "../../utils/trace_recorder.h"
 
-#define RENDER_INTERVAL 500 //ms
+#define RENDER_INTERVAL 100 //ms, minimum between two renders
 
 RendererManager::RendererManager(int area_width, int area_height,
-                                 std::function<const PlantRenderDataContainer&()> plant_rendering_data_retriever_fn,
+                                 std::function<PlantRenderDataContainer&()> plant_rendering_data_retriever_fn,
                                  std::function<const EnvironmentSpatialHashMap&()> environmental_rendering_data_retriever_fn) :
-    m_time_manager(), m_current_month(1)
+    m_time_manager("render_timer"), m_current_month(1)
 {
     m_renderers[RendererTypes::_PLANT] = new PlantRenderer(area_width, area_height, plant_rendering_data_retriever_fn);
     m_renderers[RendererTypes::_ROOTS] = new RootsRenderer(area_width, area_height, plant_rendering_data_retriever_fn);
@@ -23,6 +24,7 @@ RendererManager::RendererManager(int area_width, int area_height,
     setActiveRenderer(RendererTypes::_PLANT);
 
     m_time_manager.addListener(this);
+    m_time_manager.setMode(TimeManager::Coalescing);
     m_time_manager.setUnitTime(RENDER_INTERVAL);
 }
 
@@ -34,10 +36,17 @@ void RendererManager::stop()
 void RendererManager::start()
 {
     m_time_manager.start();
+    requestRender();
+}
+
+void RendererManager::requestRender()
+{
+    m_time_manager.requestTick();
 }
 
 void RendererManager::trigger()
 {
+    TraceRecorder::Scope trace("render");
     m_renderers[m_active_renderer]->render();
 }
 
@@ -56,6 +65,7 @@ void RendererManager::setActiveRenderer(RendererTypes p_render_type)
     m_active_renderer = p_render_type;
     inactivate_all();
     m_renderers[m_active_renderer]->setVisible(true);
+    requestRender();
 }
 
 void RendererManager::setActiveRenderer(int index)
@@ -79,14 +89,16 @@ void RendererManager::inactivate_all()
         m_renderers[i]->setVisible(false);
 }
 
-void RendererManager::filter(QString p_plant_name)
+void RendererManager::filter(int p_specie_index)
 {
-    static_cast<PlantRenderer*>(m_renderers[RendererTypes::_PLANT])->filter(p_plant_name);
-    static_cast<PlantRenderer*>(m_renderers[RendererTypes::_ROOTS])->filter(p_plant_name);
+    static_cast<PlantRenderer*>(m_renderers[RendererTypes::_PLANT])->filter(p_specie_index);
+    static_cast<PlantRenderer*>(m_renderers[RendererTypes::_ROOTS])->filter(p_specie_index);
+    requestRender();
 }
 
-void RendererManager::unfilter(QString p_plant_name)
+void RendererManager::unfilter(int p_specie_index)
 {
-    static_cast<PlantRenderer*>(m_renderers[RendererTypes::_PLANT])->unfilter(p_plant_name);
-    static_cast<PlantRenderer*>(m_renderers[RendererTypes::_ROOTS])->unfilter(p_plant_name);
+    static_cast<PlantRenderer*>(m_renderers[RendererTypes::_PLANT])->unfilter(p_specie_index);
+    static_cast<PlantRenderer*>(m_renderers[RendererTypes::_ROOTS])->unfilter(p_specie_index);
+    requestRender();
 }
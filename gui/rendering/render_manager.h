@@ -24,7 +24,7 @@ public:
     static const RendererTypes _DEFAULT_RENDER_TYPE = RendererTypes::_PLANT;
 
     RendererManager(int area_width, int area_height,
-                    std::function<const PlantRenderDataContainer&()> plant_rendering_data_retriever_fn,
+                    std::function<PlantRenderDataContainer&()> plant_rendering_data_retriever_fn,
                     std::function<const EnvironmentSpatialHashMap&()> environmental_rendering_data_retriever_fn);
 
     QString * getRendererNames();
@@ -35,12 +35,13 @@ public:
     void start();
     void hide();
     void show();
+    void requestRender(); // Renders are coalesced: at most one per render interval
 
 public slots:
     void setActiveRenderer(int index);
     void setActiveRenderer(RendererTypes p_render_type);
-    void filter(QString p_plant_name);
-    void unfilter(QString p_plant_name);
+    void filter(int p_specie_index);
+    void unfilter(int p_specie_index);
 
 private:
     QString m_render_names[_N_RENDERERS];
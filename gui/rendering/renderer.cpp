@@ -51,9 +51,9 @@ int Renderer::to_screen_space(float p_distance_in_cm)
  * PLANTS *
  **********/
 PlantRenderer::PlantRenderer(int area_width, int area_height,
-                             std::function<const PlantRenderDataContainer&()> plant_rendering_data_retriever_fn, QWidget * parent ) :
+                             std::function<PlantRenderDataContainer&()> plant_rendering_data_retriever_fn, QWidget * parent ) :
     Renderer(area_width, area_height, parent),
-    m_plant_rendering_data_retriever_fn(plant_rendering_data_retriever_fn)
+    m_plant_rendering_data_retriever_fn(plant_rendering_data_retriever_fn), m_rasterized_version(-1), m_filters_changed(false)
 {
 
 }
@@ -63,68 +63,101 @@ PlantRenderer::~PlantRenderer()
 
 }
 
-void PlantRenderer::filter(QString p_plant_name)
+void PlantRenderer::filter(int p_specie_index)
 {
-    m_filters.insert(p_plant_name);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(p_specie_index >= m_filtered_species.size())
+        m_filtered_species.resize(p_specie_index+1, false);
+    m_filtered_species[p_specie_index] = true;
+    m_filters_changed.store(true);
 }
 
-void PlantRenderer::unfilter(QString p_plant_name)
+void PlantRenderer::unfilter(int p_specie_index)
 {
-    m_filters.erase(p_plant_name);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(p_specie_index < m_filtered_species.size())
+        m_filtered_species[p_specie_index] = false;
+    m_filters_changed.store(true);
+}
+
+void PlantRenderer::render()
+{
+    PlantRenderDataContainer & plant_render_data(m_plant_rendering_data_retriever_fn());
+    if(!m_filters_changed.exchange(false) && plant_render_data.getVersion() == m_rasterized_version)
+        return;
+
+    const PlantRenderDataContainer::Frame & frame(plant_render_data.acquire());
+    std::vector<bool> filtered_species;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        filtered_species = m_filtered_species;
+    }
+    rasterize(frame, filtered_species);
+    m_rasterized_version = frame.version;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(m_displayed_image, m_backbuffer);
+    }
+    update();
 }
 
 void PlantRenderer::paintEvent(QPaintEvent * event)
 {
-    const PlantRenderDataContainer & plant_render_data(m_plant_rendering_data_retriever_fn());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(!m_displayed_image.isNull())
+    {
+        QPainter painter(this);
+        painter.drawImage(0, 0, m_displayed_image);
+    }
+}
 
-    plant_render_data.lock();
+int PlantRenderer::get_screen_radius(const PlantRenderingData & p_plant_data)
+{
+    int diameter ( to_screen_space(2*p_plant_data.canopy_radius) );
+    return std::max(1,(int)std::round(diameter/2));
+}
 
-    QPainter painter(this);
-    for(auto it = plant_render_data.begin(); it != plant_render_data.end(); it++)
+void PlantRenderer::rasterize(const PlantRenderDataContainer::Frame & p_frame, const std::vector<bool> & p_filtered_species)
+{
+    if(m_backbuffer.isNull())
+        m_backbuffer = QImage(RENDER_WINDOW_WIDTH_HEIGHT, RENDER_WINDOW_WIDTH_HEIGHT, QImage::Format_RGB32);
+    m_backbuffer.fill(Qt::black);
+
+    QPainter painter(&m_backbuffer);
+    QRgb color(0);
+    bool color_set(false);
+    for(const PlantRenderingData & plant_data : p_frame.plants)
     {
-        if(m_filters.find(it->name) == m_filters.end())
+        if(plant_data.specie_index < p_filtered_species.size() && p_filtered_species[plant_data.specie_index])
+            continue;
+
+        // Plants are sorted by height: the pen and brush only change between runs of a same color
+        if(!color_set || plant_data.color != color)
         {
-            int diameter ( to_screen_space(2*it->canopy_radius) );
-            QPoint center(to_screen_space(it->center_position.x()), to_screen_space(it->center_position.y()));
-            painter.setPen( it->color );
-            painter.setBrush( it->color );
-            int r(std::max(1,(int)std::round(diameter/2)));
-            painter.drawEllipse( center, r, r);
+            color = plant_data.color;
+            color_set = true;
+            painter.setPen( QColor(color) );
+            painter.setBrush( QColor(color) );
         }
+        int r ( get_screen_radius(plant_data) );
+        QPoint center(to_screen_space(plant_data.center_position.x()), to_screen_space(plant_data.center_position.y()));
+        painter.drawEllipse( center, r, r );
     }
-
-    plant_render_data.unlock();
 }
 
 /*********
  * ROOTS *
  *********/
-RootsRenderer::RootsRenderer(int area_width, int area_height, std::function<const PlantRenderDataContainer&()> plant_rendering_data_retriever_fn, QWidget *parent) :
+RootsRenderer::RootsRenderer(int area_width, int area_height, std::function<PlantRenderDataContainer&()> plant_rendering_data_retriever_fn, QWidget *parent) :
     PlantRenderer(area_width, area_height, plant_rendering_data_retriever_fn, parent)
 {
 
 }
 
-void RootsRenderer::paintEvent(QPaintEvent * event)
+int RootsRenderer::get_screen_radius(const PlantRenderingData & p_plant_data)
 {
-    const PlantRenderDataContainer & plant_render_data(m_plant_rendering_data_retriever_fn());
-
-    plant_render_data.lock();
-
-    QPainter painter(this);
-    for(auto it = plant_render_data.begin(); it != plant_render_data.end(); it++)
-    {
-        if(m_filters.find(it->name) == m_filters.end())
-        {
-            int r ( std::max(1,to_screen_space(it->roots_radius)) );
-            QPoint center(to_screen_space(it->center_position.x()), to_screen_space(it->center_position.y()));
-            painter.setPen( it->color );
-            painter.setBrush( it->color );
-            painter.drawEllipse( center, r, r );
-        }
-    }
-
-    plant_render_data.unlock();
+    return std::max(1,to_screen_space(p_plant_data.roots_radius));
 }
 
 /**************************
@@ -134,9 +167,9 @@ ResourceRenderer::ResourceRenderer(int area_width, int area_height, std::functio
                                    ResourceConverter * resource_visual_converter, QWidget *parent) :
     Renderer(area_width, area_height, parent),
     m_environmental_rendering_data_retriever_fn(environmental_rendering_data_retriever_fn),
-    m_resource_visual_converter(resource_visual_converter)
+    m_resource_visual_converter(resource_visual_converter), m_changes_version(-1)
 {
-
+    m_resource_visual_converter->buildLookupTable();
 }
 
 ResourceRenderer::~ResourceRenderer()
@@ -148,28 +181,51 @@ void ResourceRenderer::paintEvent(QPaintEvent * event)
 {
     const EnvironmentSpatialHashMap& environment_resources(m_environmental_rendering_data_retriever_fn());
 
-    QPainter painter(this);
+    refresh_cell_image(environment_resources);
 
-    int cell_width(environment_resources.getCellWidth());
-    int cell_width_screen_space(to_screen_space(cell_width)+1);
-    int cell_height(environment_resources.getCellHeight());
-    int cell_height_screen_space(to_screen_space(cell_height)+1);
+    QPainter painter(this);
+    painter.drawImage(QRect(0, 0, to_screen_space(environment_resources.getCellWidth() * environment_resources.getHorizontalCellCount()),
+                            to_screen_space(environment_resources.getCellHeight() * environment_resources.getVerticalCellCount())),
+                      m_cell_image);
+}
 
-    for(int x ( 0 ); x < environment_resources.getHorizontalCellCount(); x++)
+// Only visits the cells the environment reported as changed since the previous frame
+void ResourceRenderer::refresh_cell_image(const EnvironmentSpatialHashMap & environment_resources)
+{
+    int horizontal_cell_count(environment_resources.getHorizontalCellCount());
+    int vertical_cell_count(environment_resources.getVerticalCellCount());
+    m_changed_cells.clear();
+    bool redraw_all(!environment_resources.getChangedCells(m_changes_version, m_changed_cells));
+    if(m_cell_resources.size() != environment_resources.getCellCount())
     {
-        int x_screen_space(to_screen_space(cell_width * x));
+        m_cell_image = QImage(horizontal_cell_count, vertical_cell_count, QImage::Format_RGB32);
+        m_cell_resources.assign(environment_resources.getCellCount(), 0);
+        redraw_all = true;
+    }
 
-        for(int y ( 0 ); y < environment_resources.getVerticalCellCount(); y++)
+    // Cells are stored column-wise (x * rows + y)
+    QRgb * pixels(reinterpret_cast<QRgb*>(m_cell_image.bits()));
+    int pixels_per_line(m_cell_image.bytesPerLine() / sizeof(QRgb));
+    if(redraw_all)
+    {
+        for(int x(0), cell_idx(0); x < horizontal_cell_count; x++)
         {
-            QPoint cell(x,y);
-            int y_screen_space(to_screen_space(cell_height * y));
-            QColor color(Qt::black);
-            if(environment_resources.initialised(cell))
+            for(int y(0); y < vertical_cell_count; y++, cell_idx++)
             {
-                int resource_value(getResource(environment_resources, QPoint(x,y)));
-                color = QColor(m_resource_visual_converter->toRGB(resource_value));
+                m_cell_resources[cell_idx] = getResource(environment_resources, environment_resources.getCell(cell_idx));
+                pixels[y * pixels_per_line + x] = m_resource_visual_converter->lookup(m_cell_resources[cell_idx]);
             }
-            painter.fillRect(QRect(x_screen_space, y_screen_space, cell_width_screen_space, cell_height_screen_space), QBrush(color));
+        }
+        return;
+    }
+
+    for(int cell_idx : m_changed_cells)
+    {
+        int resource_value(getResource(environment_resources, environment_resources.getCell(cell_idx)));
+        if(resource_value != m_cell_resources[cell_idx])
+        {
+            m_cell_resources[cell_idx] = resource_value;
+            pixels[(cell_idx % vertical_cell_count) * pixels_per_line + cell_idx / vertical_cell_count] = m_resource_visual_converter->lookup(resource_value);
         }
     }
 }
@@ -183,9 +239,9 @@ IlluminationRenderer::IlluminationRenderer(int area_width, int area_height, std:
 {
 }
 
-int IlluminationRenderer::getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, QPoint pos)
+int IlluminationRenderer::getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, const EnvironmentSpatialHashMapCell & cell)
 {
-    return environment_spatial_hashmap.getCell(pos, EnvironmentSpatialHashMap::Space::_HASHMAP).illumination_cell.getRenderingIllumination();
+    return cell.illumination_cell.getRenderingIllumination(environment_spatial_hashmap.getAvailableIllumination());
 }
 
 /*****************
@@ -197,9 +253,9 @@ SoilHumidityRenderer::SoilHumidityRenderer(int area_width, int area_height, std:
 {
 }
 
-int SoilHumidityRenderer::getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, QPoint pos)
+int SoilHumidityRenderer::getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, const EnvironmentSpatialHashMapCell & cell)
 {
-    return environment_spatial_hashmap.getCell(pos, EnvironmentSpatialHashMap::Space::_HASHMAP).soil_humidity_cell.getRenderingHumidity();
+    return cell.soil_humidity_cell.getRenderingHumidity(environment_spatial_hashmap.getAvailableHumidity());
 }
 
 /************************
@@ -211,9 +267,9 @@ TemperatureRenderer::TemperatureRenderer(int area_width, int area_height, std::f
 {
 }
 
-int TemperatureRenderer::getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, QPoint pos)
+int TemperatureRenderer::getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, const EnvironmentSpatialHashMapCell & cell)
 {
-    return environment_spatial_hashmap.getCell(pos, EnvironmentSpatialHashMap::Space::_HASHMAP).temp_cell.getTemperature();
+    return environment_spatial_hashmap.getTemperature(); // Uniform
 //    return QRgb();
 //    TemperatureCell * cell_content(m_render_data.get_const(pos)->temp_cell);
 //    return m_translator->toRGB(cell_content->get());
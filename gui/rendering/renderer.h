@@ -10,6 +10,8 @@
 #include <unordered_set>
 
 #include <functional>
+#include <atomic>
+#include <mutex>
 #include "../../data_holders/environment_spatial_hashmap.h"
 #include "../../data_holders/plant_rendering_data_container.h"
 #include "resource_visual_converters.h"
@@ -37,21 +39,36 @@ protected:
 /**********
  * PLANTS *
  **********/
+/**
+ * Plants are rasterized by the render timer thread into a backbuffer, which is swapped with the displayed
+ * image once complete. Painting only blits the displayed image.
+ */
 class PlantRenderer : public Renderer
 {
     Q_OBJECT
 public:
-    PlantRenderer(int area_width, int area_height, std::function<const PlantRenderDataContainer&()> plant_rendering_data_retriever_fn, QWidget * parent = 0);
+    PlantRenderer(int area_width, int area_height, std::function<PlantRenderDataContainer&()> plant_rendering_data_retriever_fn, QWidget * parent = 0);
     virtual ~PlantRenderer();
-    void filter(QString p_plant_name);
-    void unfilter(QString p_plant_name);
+    void filter(int p_specie_index);
+    void unfilter(int p_specie_index);
+
+    virtual void render(); // Only rasterizes if new data has been published or the filters changed
 
 protected:
     virtual void paintEvent(QPaintEvent * event);
-    std::function<const PlantRenderDataContainer&()> m_plant_rendering_data_retriever_fn;
-    std::set<QString> m_filters;
+    virtual int get_screen_radius(const PlantRenderingData & p_plant_data); // Pixels
+
+    std::function<PlantRenderDataContainer&()> m_plant_rendering_data_retriever_fn;
 
 private:
+    void rasterize(const PlantRenderDataContainer::Frame & p_frame, const std::vector<bool> & p_filtered_species);
+
+    std::mutex m_mutex; // Guards the displayed image and the filters
+    QImage m_displayed_image;
+    QImage m_backbuffer; // Render timer thread only
+    std::vector<bool> m_filtered_species; // By specie index
+    long m_rasterized_version; // Render timer thread only
+    std::atomic<bool> m_filters_changed;
 };
 
 /*********
@@ -61,15 +78,20 @@ class RootsRenderer : public PlantRenderer
 {
     Q_OBJECT
 public:
-    RootsRenderer(int area_width, int area_height, std::function<const PlantRenderDataContainer&()> plant_rendering_data_retriever_fn, QWidget *parent = 0);
+    RootsRenderer(int area_width, int area_height, std::function<PlantRenderDataContainer&()> plant_rendering_data_retriever_fn, QWidget *parent = 0);
 
 protected:
-    virtual void paintEvent(QPaintEvent * event);
+    virtual int get_screen_radius(const PlantRenderingData & p_plant_data);
 };
 
 /**************************
  * BASE RESOURCE RENDERER *
  **************************/
+/**
+ * Environment maps are drawn into an image holding one pixel per cell, which is blitted scaled. Only the cells
+ * the environment reports as changed since the previous frame are visited, and only those whose resource changed
+ * are converted and written.
+ */
 class ResourceRenderer : public Renderer
 {
 public:
@@ -79,12 +101,18 @@ public:
 
     virtual void paintEvent(QPaintEvent * event);
 
-    virtual int getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, QPoint pos) = 0;
+    virtual int getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, const EnvironmentSpatialHashMapCell & cell) = 0;
 protected:
     std::function<const EnvironmentSpatialHashMap&()> m_environmental_rendering_data_retriever_fn;
 
 private:
+    void refresh_cell_image(const EnvironmentSpatialHashMap & environment_resources);
+
     ResourceConverter * m_resource_visual_converter;
+    QImage m_cell_image;
+    std::vector<int> m_cell_resources; // Drawn in the cell image, by flat cell index
+    long m_changes_version; // Of the environment's changed cells, see EnvironmentSpatialHashMap::getChangedCells
+    std::vector<int> m_changed_cells;
 };
 
 /************
@@ -96,7 +124,7 @@ class IlluminationRenderer : public ResourceRenderer
 public:
     IlluminationRenderer(int area_width, int area_height, std::function<const EnvironmentSpatialHashMap&()> environmental_rendering_data_retriever_fn,
                          QWidget *parent = 0);
-    int getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, QPoint pos);
+    int getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, const EnvironmentSpatialHashMapCell & cell);
 };
 
 /*****************
@@ -108,7 +136,7 @@ class SoilHumidityRenderer : public ResourceRenderer
 public:
     SoilHumidityRenderer(int area_width, int area_height, std::function<const EnvironmentSpatialHashMap&()> environmental_rendering_data_retriever_fn,
                          QWidget *parent = 0);
-    int getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, QPoint pos);
+    int getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, const EnvironmentSpatialHashMapCell & cell);
 };
 
 /************************
@@ -120,6 +148,6 @@ class TemperatureRenderer : public ResourceRenderer
 public:
     TemperatureRenderer(int area_width, int area_height, std::function<const EnvironmentSpatialHashMap&()> environmental_rendering_data_retriever_fn,
                         QWidget *parent = 0);
-    int getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, QPoint pos);
+    int getResource(const EnvironmentSpatialHashMap & environment_spatial_hashmap, const EnvironmentSpatialHashMapCell & cell);
 };
 #endif //RENDERER_H
@@ -18,6 +18,13 @@ ResourceConverter::~ResourceConverter()
 
 }
 
+void ResourceConverter::buildLookupTable()
+{
+    m_lookup_table.resize(m_max - m_min + 1);
+    for(int value(m_min); value <= m_max; value++)
+        m_lookup_table[value - m_min] = toRGB(value);
+}
+
 /*****************
  * SOIL HUMIDITY *
  *****************/
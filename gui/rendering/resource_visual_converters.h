@@ -2,6 +2,7 @@
 #define RESOURCE_VISUAL_CONVERTERS_H
 
 #include <QColor>
+#include <vector>
 
 class ResourceConverter {
 public:
@@ -10,8 +11,20 @@ public:
     virtual int toValue(QRgb p_pixel) const = 0;
     virtual QRgb toRGB(int p_value) const = 0 ;
 
+    void buildLookupTable(); // Caches toRGB for every value within [min, max]
+
+    // Same as toRGB, through the lookup table when built
+    QRgb lookup(int p_value) const
+    {
+        unsigned int idx(p_value - m_min);
+        return idx < m_lookup_table.size() ? m_lookup_table[idx] : toRGB(p_value);
+    }
+
 protected:
     int m_min, m_max, m_range;
+
+private:
+    std::vector<QRgb> m_lookup_table;
 };
 
 /*****************
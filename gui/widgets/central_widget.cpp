@@ -10,6 +10,8 @@
 #include <QDebug>
 #include <QCheckBox>
 #include <QFile>
+#include <QFileDialog>
+#include <QInputDialog>
 
 /************************
  * ANIMATED PUSH BUTTON *
@@ -71,6 +73,8 @@ CentralWidget::CentralWidget(QWidget * parent, Qt::WindowFlags f) :
     init_layout();
     init_signals();
 
+    m_simulator_manager.getProfiler().setEnabled(true);
+
     m_enable_render_cb->setChecked(true);
     m_renderers_cb->setCurrentIndex(static_cast<int>(RendererManager::_DEFAULT_RENDER_TYPE));
     active_renderer(true);
@@ -99,6 +103,30 @@ void CentralWidget::active_renderer(bool activate)
 //    this->adjustSize();
 }
 
+void CentralWidget::filter_specie(QString p_specie_name)
+{
+    int specie_index(get_specie_index(p_specie_name));
+    if(specie_index != -1)
+        m_render_manager.filter(specie_index);
+}
+
+void CentralWidget::unfilter_specie(QString p_specie_name)
+{
+    int specie_index(get_specie_index(p_specie_name));
+    if(specie_index != -1)
+        m_render_manager.unfilter(specie_index);
+}
+
+int CentralWidget::get_specie_index(const QString & p_specie_name) const
+{
+    for(const Specie & specie : m_simulator_manager.getSpecieTable())
+    {
+        if(specie.m_specie_name == p_specie_name)
+            return specie.m_index;
+    }
+    return -1;
+}
+
 void CentralWidget::init_layout()
 {
     // Time slider
@@ -127,6 +155,12 @@ void CentralWidget::init_layout()
             info_heading_layout->addWidget(m_elapsed_time_lbl, 0, Qt::AlignCenter);
         }
 
+        // Profile label
+        {
+            m_profile_lbl = new QLabel();
+            info_heading_layout->addWidget(m_profile_lbl, 0, Qt::AlignCenter);
+        }
+
         // QButtons
         {
             m_stop_start_button = new QPushButton(START_BTN_TEXT);
@@ -207,11 +241,11 @@ void CentralWidget::init_signals()
     connect(&m_simulator_manager, SIGNAL(removedPlant(QString, QString)), m_overview_widget, SLOT(removePlant(QString,QString)));
 
     // The overview widget render filter
-    connect(m_overview_widget, SIGNAL(filter(QString)), &m_render_manager, SLOT(filter(QString)));
-    connect(m_overview_widget, SIGNAL(unfilter(QString)), &m_render_manager, SLOT(unfilter(QString)));
+    connect(m_overview_widget, SIGNAL(filter(QString)), this, SLOT(filter_specie(QString)));
+    connect(m_overview_widget, SIGNAL(unfilter(QString)), this, SLOT(unfilter_specie(QString)));
 
     // Snapshot generation
-    connect(m_generate_snapshot_btn, SIGNAL(clicked()), &m_simulator_manager, SLOT(generateSnapshot()));
+    connect(m_generate_snapshot_btn, SIGNAL(clicked()), this, SLOT(generate_snapshot()));
     connect(m_generate_statistical_snapshot_btn, SIGNAL(clicked()), this, SLOT(generate_statistical_snapshot()));
 
     // Config dialog
@@ -222,6 +256,42 @@ void CentralWidget::updateRender()
 {
     // Update info
     update_elapsed_time_label(m_simulator_manager.getElapsedMonths());
+    update_profile_label();
+    m_render_manager.requestRender();
+}
+
+void CentralWidget::update_profile_label()
+{
+    const SimulationProfiler & profiler(m_simulator_manager.getProfiler());
+    if(!profiler.hasProfiles())
+    {
+        m_profile_lbl->clear();
+        m_profile_lbl->setToolTip(QString());
+        return;
+    }
+
+    SimulationProfiler::MonthProfile profile(profiler.getLastMonth());
+    QString text(QString("Last month: %1 ms (").arg(profile.total_time, 0, 'f', 1));
+    for(int i(0); i < SimulationProfiler::_N_PHASES; i++)
+    {
+        if(i > 0)
+            text.append(", ");
+        text.append(QString("%1: %2").arg(QString(SimulationProfiler::getPhaseName((SimulationProfiler::Phase) i)).replace('_', ' '))
+                    .arg(profile.phase_times[i], 0, 'f', 1));
+    }
+    text.append(QString(") - Storage lock wait: %1 ms")
+                .arg(profile.lock_wait_times[SimulationProfiler::PlantStorageLock], 0, 'f', 1));
+    m_profile_lbl->setText(text);
+
+    // Distribution of the month times over the rolling window
+    std::vector<int> histogram(profiler.getMonthHistogram());
+    QString tooltip("Month times (last months):");
+    for(int bucket(0); bucket < histogram.size(); bucket++)
+    {
+        if(histogram[bucket] > 0)
+            tooltip.append(QString("\n%1 - %2 ms: %3").arg((1 << bucket)/1000.0).arg((2 << bucket)/1000.0).arg(histogram[bucket]));
+    }
+    m_profile_lbl->setToolTip(tooltip);
 }
 
 void CentralWidget::update_elapsed_time_label(int p_months)
@@ -300,6 +370,26 @@ void CentralWidget::display_start_configuration_dialog()
     m_start_config_dialog.exec();
 }
 
+void CentralWidget::generate_snapshot()
+{
+    SnapshotSettings settings(m_simulator_manager.getSnapshotSettings());
+    QString directory(QFileDialog::getExistingDirectory(this, "Snapshot directory", settings.directory));
+    if(directory.isEmpty())
+        return;
+
+    bool ok;
+    int resolution(QInputDialog::getInt(this, "Snapshot resolution", "Pixels per side:",
+                                        settings.resolution > 0 ? settings.resolution : SimulatorManager::_AREA_WIDTH_HEIGHT,
+                                        100, 100000, 100, &ok));
+    if(!ok)
+        return;
+
+    settings.directory = directory;
+    settings.resolution = resolution;
+    m_simulator_manager.setSnapshotSettings(settings);
+    m_simulator_manager.generateSnapshot();
+}
+
 void CentralWidget::generate_statistical_snapshot()
 {
     m_generate_statistical_snapshot_btn->startAnimation();
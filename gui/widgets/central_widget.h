@@ -67,14 +67,19 @@ private slots:
     void pause_resume_btn_clicked();
     void display_start_configuration_dialog();
     void start_simulation();
+    void generate_snapshot();
     void generate_statistical_snapshot();
     void active_renderer(bool);
+    void filter_specie(QString p_specie_name);
+    void unfilter_specie(QString p_specie_name);
 
 private:
     void init_layout();
     void init_widgets();
     void init_signals();
     void update_elapsed_time_label(int p_months);
+    void update_profile_label();
+    int get_specie_index(const QString & p_specie_name) const; // -1 if unknown
 
     SimulatorManager m_simulator_manager;
     RendererManager m_render_manager;
@@ -91,6 +96,7 @@ private:
     AnimatedPushButton * m_generate_statistical_snapshot_btn;
     QLabel * m_trigger_frequency_lbl;
     QLabel * m_elapsed_time_lbl;
+    QLabel * m_profile_lbl;
     QComboBox * m_renderers_cb;
     QPushButton * m_stop_start_button;
     QPushButton * m_pause_resume_button;
@@ -1,14 +1,35 @@
 #include <QApplication>
 #include "gui/main_window.h"
+#include "utils/trace_recorder.h"
+#include "utils/tracker_writer.h"
 #include <QDebug>
 
 int main(int argc, char *argv[])
 {
     qWarning() << "Launching Ecosimulator...";
     QApplication app(argc, argv);
+
+    // Timeline of every thread, written on exit (chrome://tracing, ui.perfetto.dev)
+    QString trace_file(qgetenv("ECOSIM_TRACE"));
+    if(!trace_file.isEmpty())
+    {
+        TraceRecorder::start();
+        TraceRecorder::setThreadName("gui");
+    }
+
     MainWindow w;
     w.resize(w.sizeHint());
     w.showMaximized();
 
-    return app.exec();
+    int status(app.exec());
+    TrackerWriter::instance().flush();
+
+    if(!trace_file.isEmpty())
+    {
+        TraceRecorder::stop();
+        if(!TraceRecorder::write(trace_file.toStdString()))
+            qCritical() << "Unable to write the trace to" << trace_file;
+    }
+
+    return status;
 }
@@ -0,0 +1,22 @@
+#include "random_streams.h"
+
+/*****************
+ * RANDOM STREAM *
+ *****************/
+RandomStream::RandomStream(std::uint64_t p_key) : m_key(p_key), m_counter(0)
+{
+
+}
+
+/******************
+ * RANDOM STREAMS *
+ ******************/
+RandomStreams::RandomStreams(unsigned int p_seed) : m_seed(p_seed)
+{
+
+}
+
+unsigned int RandomStreams::getSeed() const
+{
+    return m_seed;
+}
@@ -0,0 +1,86 @@
+#ifndef RANDOM_STREAMS_H
+#define RANDOM_STREAMS_H
+
+#include <cstdint>
+
+/*****************
+ * RANDOM STREAM *
+ *****************/
+/**
+ * Counter-based random stream: the n-th draw is a hash of the stream key and n. A stream holds no engine state
+ * besides its key and counter so it is cheap to create, copy and throw away.
+ */
+class RandomStream {
+public:
+    RandomStream(std::uint64_t p_key);
+
+    std::uint64_t next();
+    int uniformInt(int p_from, int p_to); // Inclusive
+    float uniformFloat(); // [0,1)
+
+    static std::uint64_t mix(std::uint64_t p_value);
+
+private:
+    std::uint64_t m_key;
+    std::uint64_t m_counter;
+};
+
+inline std::uint64_t RandomStream::mix(std::uint64_t p_value)
+{
+    // SplitMix64 finalizer
+    p_value = (p_value ^ (p_value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    p_value = (p_value ^ (p_value >> 27)) * 0x94d049bb133111ebULL;
+    return p_value ^ (p_value >> 31);
+}
+
+inline std::uint64_t RandomStream::next()
+{
+    return mix(m_key + (++m_counter) * 0x9e3779b97f4a7c15ULL);
+}
+
+inline int RandomStream::uniformInt(int p_from, int p_to)
+{
+    std::uint64_t range(((std::int64_t) p_to) - p_from + 1);
+    return p_from + (int) (((next() >> 32) * range) >> 32);
+}
+
+inline float RandomStream::uniformFloat()
+{
+    return (next() >> 40) * (1.f / 16777216.f); // 24 bits --> exact in a float
+}
+
+/******************
+ * RANDOM STREAMS *
+ ******************/
+/**
+ * Derives independent random streams from the run seed. A stream is keyed by what it is used for, the entity it is
+ * used for (plant id, specie id, ...) and the month so the draws do not depend on the order in which entities are
+ * processed nor on the number of threads processing them.
+ */
+class RandomStreams {
+public:
+    enum Purpose{
+        PlantPlacement,
+        PlantRandomId,
+        Growth,
+        Seeding
+    };
+
+    RandomStreams(unsigned int p_seed = 0);
+
+    RandomStream stream(Purpose p_purpose, std::int64_t p_key, int p_month = 0) const;
+    unsigned int getSeed() const;
+
+private:
+    unsigned int m_seed;
+};
+
+inline RandomStream RandomStreams::stream(Purpose p_purpose, std::int64_t p_key, int p_month) const
+{
+    std::uint64_t key(RandomStream::mix(m_seed + 0x9e3779b97f4a7c15ULL * (p_purpose + 1)));
+    key = RandomStream::mix(key ^ (std::uint64_t) p_key);
+    key = RandomStream::mix(key ^ (((std::uint64_t) (std::uint32_t) p_month) << 32));
+    return RandomStream(key);
+}
+
+#endif // RANDOM_STREAMS_H
@@ -1,8 +1,6 @@
 #include "environment_illumination.h"
-#include <QImage>
 #include <math.h>
 
-#include "../data_holders/pixel_data.h"
 
 #include <QDebug>
 
@@ -19,34 +17,46 @@ EnvironmentIllumination::EnvironmentIllumination()
 #define HEIGHT_BUFFER 5 //cm
 int EnvironmentIllumination::getDailyIllumination(EnvironmentSpatialHashMap & map, QPoint p_center, int p_id, float p_canopy_width, float height)
 {
-    std::vector<QPoint> cells(map.getPoints(p_center, p_canopy_width/2));
-
     float aggregated_daily_illumination(0);
+    int cell_count(0);
+    int available_illumination(map.getAvailableIllumination());
 
-    for(QPoint & cell : cells)
+    for(const CellSpan span : map.getFootprint(p_center, p_canopy_width/2))
     {
-        aggregated_daily_illumination += map.getCell(cell, EnvironmentSpatialHashMap::Space::_HASHMAP).illumination_cell.getIllumination(p_id, height);
+        int index(map.index(QPoint(span.x, span.y_begin)));
+        for(int y(span.y_begin); y < span.y_end; y++, index++)
+            aggregated_daily_illumination += map.getCell(index).illumination_cell.getIllumination(p_id, height, available_illumination);
+        cell_count += span.y_end - span.y_begin;
     }
 
-    return std::round(aggregated_daily_illumination/cells.size()); // Divide by cells iterated over
+    if(cell_count == 0) // Footprint entirely off the grid
+        return 0;
+
+    return std::round(aggregated_daily_illumination/cell_count); // Divide by cells iterated over
 }
 
-void EnvironmentIllumination::update(EnvironmentSpatialHashMap & map, QPoint p_center, float p_canopy_width, float p_height, int p_id)
+/**
+ * The height is kept per plant by the map: a height change only touches the cells the plant covered, and the
+ * footprint change only the cells which entered it and those which left it.
+ */
+int EnvironmentIllumination::update(EnvironmentSpatialHashMap & map, const Footprint & p_previous, const Footprint & p_current, float p_height, int p_id)
 {
-    std::vector<QPoint> cells(map.getPoints(p_center, p_canopy_width/2));
+    const std::vector<float> & heights(map.getPlantHeights());
+    auto add_cell([p_id, &heights](EnvironmentSpatialHashMapCell & cell) { cell.illumination_cell.add(p_id, heights); });
+    auto remove_cell([p_id, &heights](EnvironmentSpatialHashMapCell & cell) { cell.illumination_cell.remove(p_id, heights); });
 
-    for(QPoint & cell : cells)
-    {
-        map.getCell(cell, EnvironmentSpatialHashMap::Space::_HASHMAP).illumination_cell.update(p_id, p_height);
-    }
+    int touched_cells(map.setPlantHeight(p_id, p_height, p_previous));
+    p_current.forEachSpanNotIn(p_previous, [&](const CellSpan & span) { touched_cells += map.forEachChangedCell(span, add_cell); });
+    p_previous.forEachSpanNotIn(p_current, [&](const CellSpan & span) { touched_cells += map.forEachChangedCell(span, remove_cell); });
+
+    return touched_cells;
 }
 
-void EnvironmentIllumination::remove(EnvironmentSpatialHashMap & map, QPoint p_center, float p_canopy_width, int p_id)
+int EnvironmentIllumination::remove(EnvironmentSpatialHashMap & map, const Footprint & p_footprint, int p_id)
 {
-    std::vector<QPoint> cells(map.getPoints(p_center, p_canopy_width/2));
-
-    for(QPoint & cell : cells)
-    {
-        map.getCell(cell, EnvironmentSpatialHashMap::Space::_HASHMAP).illumination_cell.remove(p_id);
-    }
+    const std::vector<float> & heights(map.getPlantHeights());
+    int touched_cells(0);
+    for(const CellSpan span : p_footprint)
+        touched_cells += map.forEachChangedCell(span, [p_id, &heights](EnvironmentSpatialHashMapCell & cell) { cell.illumination_cell.remove(p_id, heights); });
+    return touched_cells;
 }
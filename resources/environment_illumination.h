@@ -2,7 +2,6 @@
 #define ENVIRONMNENT_ILLUMINATION_H
 
 #include <QPoint>
-#include <QImage>
 #include <unordered_map>
 #include <memory>
 
@@ -17,8 +16,9 @@ public:
     EnvironmentIllumination();
 
     int getDailyIllumination(EnvironmentSpatialHashMap & map, QPoint p_center, int p_id, float p_canopy_width, float height);
-    void update(EnvironmentSpatialHashMap & map, QPoint p_center, float p_canopy_width, float height, int p_id);
-    void remove(EnvironmentSpatialHashMap & map, QPoint p_center, float p_canopy_width, int p_id);
+    // Both return the number of cells touched
+    int update(EnvironmentSpatialHashMap & map, const Footprint & p_previous, const Footprint & p_current, float p_height, int p_id);
+    int remove(EnvironmentSpatialHashMap & map, const Footprint & p_footprint, int p_id);
 //    float getMaxHeight(QPoint p_cell_coord);
 
 protected:
@@ -2,7 +2,7 @@
 
 EnvironmentManager::EnvironmentManager(int area_width, int area_height) :
     m_environment_spatial_hashmap(area_width, area_height), m_resource_controllers(),
-    m_month(-1)
+    m_touched_cell_count(0), m_month(-1)
 {
 
 }
@@ -32,11 +32,16 @@ float EnvironmentManager::getSlope()
     return m_slope;
 }
 
+// Removes what was last stamped for the plant
 void EnvironmentManager::remove(QPoint p_center, float p_canopy_width, float p_roots_size, int p_id)
 {
-    if(p_canopy_width > 0)
-        m_resource_controllers.illumination.remove(m_environment_spatial_hashmap, p_center, p_canopy_width, p_id);
-    m_resource_controllers.soil_humidity.remove(m_environment_spatial_hashmap, p_center, p_roots_size, p_id);
+    if(p_id >= m_stamps.size() || !m_stamps[p_id].stamped)
+        return;
+
+    EnvironmentStamp & stamp(m_stamps[p_id]);
+    m_touched_cell_count += m_resource_controllers.illumination.remove(m_environment_spatial_hashmap, stamp.canopy, p_id);
+    m_touched_cell_count += m_resource_controllers.soil_humidity.remove(m_environment_spatial_hashmap, stamp.roots, p_id);
+    stamp = EnvironmentStamp();
 }
 
 const EnvironmentSpatialHashMap & EnvironmentManager::getRenderingData()
@@ -44,26 +49,58 @@ const EnvironmentSpatialHashMap & EnvironmentManager::getRenderingData()
     return m_environment_spatial_hashmap;
 }
 
+// Cells written by updates and removals since the last call
+long EnvironmentManager::takeTouchedCellCount()
+{
+    long touched_cell_count(m_touched_cell_count);
+    m_touched_cell_count = 0;
+    return touched_cell_count;
+}
+
+void EnvironmentManager::publishChangedCells()
+{
+    m_environment_spatial_hashmap.publishChangedCells();
+}
+
 void EnvironmentManager::reset()
 {
     m_environment_spatial_hashmap.clear();
+    m_stamps.clear();
 }
 
+// Once refreshed, the getters can safely be called from several threads until the next update
+void EnvironmentManager::refresh()
+{
+    m_resource_controllers.soil_humidity.solve(m_environment_spatial_hashmap);
+}
+
+/**
+ * Heights and humidity requests are kept per plant, the cells only recording which plants cover them: a plant
+ * growing within its footprint touches no cell and a growing footprint only touches the ring of cells it gained.
+ */
 void EnvironmentManager::updateEnvironment(QPoint p_center, float p_canopy_width, float p_height, float p_roots_size, int p_id, int p_minimum_soil_humidity_request)
 {
+    if(p_id >= m_stamps.size()) // Plant ids are recycled by the storage so this remains bounded
+        m_stamps.resize(p_id+1);
+
+    EnvironmentStamp & stamp(m_stamps[p_id]);
+
     // Update illumination manager - No affect on illumination if canopy width is zero
-    if(p_canopy_width > 0)
-        m_resource_controllers.illumination.update(m_environment_spatial_hashmap, p_center, p_canopy_width, p_height, p_id);
+    Footprint canopy(p_canopy_width > 0 ? m_environment_spatial_hashmap.getFootprint(p_center, p_canopy_width/2) : Footprint());
+    m_touched_cell_count += m_resource_controllers.illumination.update(m_environment_spatial_hashmap, stamp.canopy, canopy, p_height, p_id);
 
     // Update soil humidity
-    m_resource_controllers.soil_humidity.update(m_environment_spatial_hashmap, p_center, p_roots_size, p_id, p_minimum_soil_humidity_request);
-}
+    Footprint roots(m_environment_spatial_hashmap.getFootprint(p_center, p_roots_size));
+    m_touched_cell_count += m_resource_controllers.soil_humidity.update(m_environment_spatial_hashmap, stamp.roots, roots, p_roots_size, p_id,
+                                                                        p_minimum_soil_humidity_request);
 
+    stamp.stamped = true;
+    stamp.canopy = canopy;
+    stamp.roots = roots;
+}
 
 void EnvironmentManager::setEnvironmentProperties( float slope, std::vector<int> humidity, std::vector<int> illumination, std::vector<int> temperature )
 {
-    m_environment_spatial_hashmap.resetAllCells();
-
     m_slope = slope;
     m_humidities = humidity;
     m_illuminations = illumination;
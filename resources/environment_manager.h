@@ -14,6 +14,15 @@ struct ResourceControllers{
     ResourceControllers() {}
 };
 
+// Cells a plant was last added to
+struct EnvironmentStamp{
+    bool stamped;
+    Footprint canopy;
+    Footprint roots;
+
+    EnvironmentStamp() : stamped(false), canopy(), roots() {}
+};
+
 class EnvironmentManager{
 public:
     EnvironmentManager(int area_width, int area_height);
@@ -27,6 +36,9 @@ public:
     void setMonth(int p_month);
     void remove(QPoint p_center, float p_canopy_width, float p_roots_size, int p_id);
     void reset();
+    void refresh();
+    long takeTouchedCellCount();
+    void publishChangedCells(); // Hands the cells touched since the last call over to the renderers
 
     void updateEnvironment(QPoint p_center, float p_canopy_width, float p_height, float p_roots_size, int p_id, int p_minimum_soil_humidity_request);
 
@@ -39,6 +51,8 @@ public:
 private:
     EnvironmentSpatialHashMap m_environment_spatial_hashmap;
     ResourceControllers m_resource_controllers;
+    std::vector<EnvironmentStamp> m_stamps; // Indexed by plant id
+    long m_touched_cell_count;
 
     int m_month;
     int m_slope;
@@ -1,6 +1,6 @@
 #include "environment_soil_humidity.h"
 #include <math.h>
-#include "../data_holders/pixel_data.h"
+#include <algorithm>
 #include <QDebug>
 
 EnvironmentSoilHumidity::EnvironmentSoilHumidity()
@@ -8,37 +8,61 @@ EnvironmentSoilHumidity::EnvironmentSoilHumidity()
 
 }
 
+// Requires the grants to have been solved since the last update
 int EnvironmentSoilHumidity::getSoilHumidity(EnvironmentSpatialHashMap & map, QPoint p_center, float p_roots_size, int p_id)
 {
-    std::vector<QPoint> cells(map.getPoints(p_center, p_roots_size));
+    int cell_count(0);
 
-    int aggregated_humidity_percentage(0);
+    for(const CellSpan span : map.getFootprint(p_center, p_roots_size))
+        cell_count += span.y_end - span.y_begin;
 
-    for(QPoint & cell : cells)
-    {
-        aggregated_humidity_percentage +=  map.getCell(cell, EnvironmentSpatialHashMap::Space::_HASHMAP).soil_humidity_cell.getGrantedHumidity(p_id);
-    }
-    return aggregated_humidity_percentage/cells.size(); // Return percentage
+    if(cell_count == 0) // Footprint entirely off the grid
+        return 0;
+
+    return m_granted_humidity_totals[p_id]/cell_count; // Return percentage
+}
+
+/**
+ * The request is kept per plant by the map: a change of size only touches the cells the plant was rooted in, and
+ * the footprint change only the cells which entered it and those which left it.
+ */
+int EnvironmentSoilHumidity::update(EnvironmentSpatialHashMap & map, const Footprint & p_previous, const Footprint & p_current, float p_roots_size, int p_id,
+                                    int p_minimum_humidity)
+{
+    if(p_id >= m_granted_humidity_totals.size()) // Plant ids are recycled by the storage so this remains bounded
+        m_granted_humidity_totals.resize(p_id+1, 0);
+
+    const std::vector<ResourceUsageRequest> & requests(map.getPlantRequests());
+    auto add_cell([p_id, &requests](EnvironmentSpatialHashMapCell & cell) { cell.soil_humidity_cell.add(p_id, requests); });
+    auto remove_cell([p_id](EnvironmentSpatialHashMapCell & cell) { cell.soil_humidity_cell.remove(p_id); });
+
+    int touched_cells(map.setPlantRequest(p_id, p_roots_size, p_minimum_humidity, p_previous));
+    p_current.forEachSpanNotIn(p_previous, [&](const CellSpan & span) { touched_cells += map.forEachChangedCell(span, add_cell); });
+    p_previous.forEachSpanNotIn(p_current, [&](const CellSpan & span) { touched_cells += map.forEachChangedCell(span, remove_cell); });
+
+    return touched_cells;
 }
 
-// DO NOT CALL THIS METHOD FOLLOWED BY GETHUMIDITY CONTRINUOUSLY RATHER UPDATE THIS FOR ALL NECESSARY CELLS IN ONE GO
-void EnvironmentSoilHumidity::update(EnvironmentSpatialHashMap & map, QPoint p_center, float p_roots_size, int p_id, int p_minimum_humidity)
+int EnvironmentSoilHumidity::remove(EnvironmentSpatialHashMap & map, const Footprint & p_footprint, int p_id)
 {
-    std::vector<QPoint> cells(map.getPoints(p_center, p_roots_size));
-    for(QPoint & cell : cells)
-    {
-         map.getCell(cell, EnvironmentSpatialHashMap::Space::_HASHMAP).soil_humidity_cell.update(p_id, p_roots_size, p_minimum_humidity);
-    }
+    int touched_cells(0);
+    for(const CellSpan span : p_footprint)
+        touched_cells += map.forEachChangedCell(span, [p_id](EnvironmentSpatialHashMapCell & cell) { cell.soil_humidity_cell.remove(p_id); });
+    return touched_cells;
 }
 
-void EnvironmentSoilHumidity::remove(EnvironmentSpatialHashMap & map, QPoint p_center, float p_roots_size, int p_id)
+/**
+ * Single sweep over the cells: each cell splits its humidity once between the plants rooted in it and
+ * the grants are accumulated into per-plant totals.
+ */
+void EnvironmentSoilHumidity::solve(EnvironmentSpatialHashMap & map)
 {
-    std::vector<QPoint> cells(map.getPoints(p_center, p_roots_size));
+    std::fill(m_granted_humidity_totals.begin(), m_granted_humidity_totals.end(), 0);
 
-    for(QPoint & cell : cells)
-    {
-         map.getCell(cell, EnvironmentSpatialHashMap::Space::_HASHMAP).soil_humidity_cell.remove(p_id);
-    }
+    int available_humidity(map.getAvailableHumidity());
+    const std::vector<ResourceUsageRequest> & requests(map.getPlantRequests());
+    for(auto it(map.begin()); it != map.end(); it++)
+        it->soil_humidity_cell.grant(m_granted_humidity_totals, available_humidity, requests);
 }
 
 //std::pair<int,int> EnvironmentSoilHumidity::getRange()
@@ -2,8 +2,8 @@
 #define ENVIRONMNENT_SOIL_HUMIDITY_H
 
 #include <QPoint>
-#include <QImage>
 #include <memory>
+#include <vector>
 #include "../data_holders/environment_spatial_hashmap.h"
 
 class EnvironmentSoilHumidity
@@ -15,10 +15,14 @@ public:
     EnvironmentSoilHumidity();
     void setSoilHumidityData(int humidity[12]);
     int getSoilHumidity(EnvironmentSpatialHashMap & map, QPoint p_center, float p_roots_size, int p_id);
-    void update(EnvironmentSpatialHashMap & map, QPoint p_center, float p_roots_size, int p_id, int p_minimum_humidity);
-    void remove(EnvironmentSpatialHashMap & map, QPoint p_center, float p_roots_size, int p_id);
+    // Both return the number of cells touched
+    int update(EnvironmentSpatialHashMap & map, const Footprint & p_previous, const Footprint & p_current, float p_roots_size, int p_id,
+               int p_minimum_humidity);
+    int remove(EnvironmentSpatialHashMap & map, const Footprint & p_footprint, int p_id);
+    void solve(EnvironmentSpatialHashMap & map);
 
 private:
+    std::vector<int> m_granted_humidity_totals; // Indexed by plant id
 };
 
 #endif //ENVIRONMNENT_SOIL_HUMIDITY_H
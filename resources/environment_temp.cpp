@@ -1,5 +1,4 @@
 #include "environment_temp.h"
-#include "../data_holders/pixel_data.h"
 
 EnvironmentTemperature::EnvironmentTemperature()
 {
@@ -2,11 +2,9 @@
 #define ENVIRONMNENT_TEMPERATURE_H
 
 #include <QPoint>
-#include <QImage>
 #include <memory>
 #include "../data_holders/environment_spatial_hashmap.h"
 
-class PixelData;
 class EnvironmentTemperature
 {
 public:
@@ -0,0 +1,390 @@
+#include "radial_distribution_analyzer.h"
+#include "../../utils/thread_pool.h"
+#include "../../utils/trace_recorder.h"
+#include "../../math/random_streams.h"
+
+#include <algorithm>
+#include <fstream>
+#include <math.h>
+
+const int RadialDistributionAnalyzer::_CELL_SIZE = 100;
+const int RadialDistributionAnalyzer::_TILE_ROWS = 8;
+const float RadialDistributionAnalyzer::_CONFIDENCE_Z = 1.96f;
+
+RadialDistributionAnalyzer::RadialDistributionAnalyzer(int p_r_min, int p_r_max, int p_r_diff, int p_area_width, int p_area_height) :
+    m_r_min(p_r_min), m_r_max(p_r_max), m_r_diff(p_r_diff), m_area_width(p_area_width), m_area_height(p_area_height),
+    m_columns(std::max(1, (int) std::ceil(((float)p_area_width)/_CELL_SIZE))),
+    m_rows(std::max(1, (int) std::ceil(((float)p_area_height)/_CELL_SIZE)))
+{
+
+}
+
+int RadialDistributionAnalyzer::getAnnulusCount() const
+{
+    return (m_r_max - m_r_min) / m_r_diff;
+}
+
+std::vector<RadialDistribution> RadialDistributionAnalyzer::analyze(const Categories & p_categories, const std::vector<int> & p_priority_sorted_ids,
+                                                                    ThreadPool & p_thread_pool, int p_sample_budget) const
+{
+    TraceRecorder::Scope trace("radial_distribution");
+
+    // Bucket each category once
+    std::map<int, CategoryGrid> grids;
+    for(int id : p_priority_sorted_ids)
+    {
+        auto category(p_categories.find(id));
+        if(category != p_categories.end())
+            grids.emplace(id, build_grid(category->second));
+    }
+
+    std::vector<std::pair<int,int> > pairs; // Reference, target
+    for(int reference(0); reference < p_priority_sorted_ids.size(); reference++)
+    {
+        if(grids.find(p_priority_sorted_ids[reference]) == grids.end())
+            continue;
+        for(int target(0); target <= reference; target++)
+        {
+            if(grids.find(p_priority_sorted_ids[target]) != grids.end())
+                pairs.push_back(std::make_pair(p_priority_sorted_ids[reference], p_priority_sorted_ids[target]));
+        }
+    }
+
+    // Strata of each reference category, shared by all its targets so they are analysed against the same sample
+    std::map<int, std::vector<Stratum> > strata;
+    for(const auto & grid : grids)
+        strata.emplace(grid.first, stratify(grid.second, p_sample_budget));
+
+    // One task per pair and stratum
+    std::vector<std::pair<int,int> > tasks; // Pair index, stratum index
+    std::vector<int> pair_first_tasks;
+    for(int pair_idx(0); pair_idx < pairs.size(); pair_idx++)
+    {
+        pair_first_tasks.push_back(tasks.size());
+        for(int stratum(0); stratum < strata.at(pairs[pair_idx].first).size(); stratum++)
+            tasks.push_back(std::make_pair(pair_idx, stratum));
+    }
+    pair_first_tasks.push_back(tasks.size());
+
+    int annulus_count(getAnnulusCount());
+    int task_count(tasks.size());
+
+    // One set of counts per task, combined afterwards so the result does not depend on the scheduling
+    std::vector<StratumCounts> task_counts(task_count, StratumCounts{0, 0, std::vector<double>(annulus_count, .0),
+                                                                     std::vector<double>(annulus_count, .0)});
+    p_thread_pool.run(task_count, [&](int p_task, int p_thread_idx) {
+        const std::pair<int,int> & pair(pairs[tasks[p_task].first]);
+        int stratum_idx(tasks[p_task].second);
+        const Stratum & stratum(strata.at(pair.first)[stratum_idx]);
+        std::uint64_t sampling_key(RandomStream::mix((((std::uint64_t) pair.first) << 32) | stratum_idx));
+        count_pairs(grids.at(pair.first), grids.at(pair.second), pair.first == pair.second, stratum, sampling_key, task_counts[p_task]);
+    });
+
+    std::vector<RadialDistribution> distributions;
+    distributions.reserve(pairs.size());
+    for(int pair_idx(0); pair_idx < pairs.size(); pair_idx++)
+    {
+        const CategoryGrid & reference(grids.at(pairs[pair_idx].first));
+        const CategoryGrid & target(grids.at(pairs[pair_idx].second));
+        bool same_category(pairs[pair_idx].first == pairs[pair_idx].second);
+
+        RadialDistribution distribution{pairs[pair_idx].first, pairs[pair_idx].second, m_r_min, m_r_diff, std::vector<double>(annulus_count, .0),
+                    std::vector<float>(annulus_count, .0f), std::vector<float>(annulus_count, .0f), std::vector<float>(annulus_count, .0f),
+                    (int) reference.points.size(), 0};
+
+        // Stratified estimator: sum over the strata of population x sample mean
+        std::vector<double> variances(annulus_count, .0);
+        for(int task(pair_first_tasks[pair_idx]); task < pair_first_tasks[pair_idx+1]; task++)
+        {
+            const StratumCounts & stratum(task_counts[task]);
+            if(stratum.samples == 0)
+                continue;
+            distribution.sampled_reference_count += stratum.samples;
+            double weight(((double) stratum.population) / stratum.samples);
+            for(int annulus(0); annulus < annulus_count; annulus++)
+            {
+                distribution.pair_counts[annulus] += weight * stratum.sums[annulus];
+                if(stratum.samples > 1 && stratum.samples < stratum.population)
+                {
+                    double mean(stratum.sums[annulus] / stratum.samples);
+                    double sample_variance((stratum.squared_sums[annulus] - stratum.samples * mean * mean) / (stratum.samples - 1));
+                    double finite_population_correction(1 - ((double) stratum.samples) / stratum.population);
+                    variances[annulus] += ((double) stratum.population) * stratum.population * finite_population_correction *
+                            std::max(.0, sample_variance) / stratum.samples;
+                }
+            }
+        }
+        for(int annulus(0); annulus < annulus_count; annulus++)
+        {
+            float expected(expected_pairs(reference, target, same_category, annulus));
+            if(expected > 0)
+            {
+                double margin(_CONFIDENCE_Z * std::sqrt(variances[annulus]));
+                distribution.values[annulus] = distribution.pair_counts[annulus] / expected;
+                distribution.lower_bounds[annulus] = std::max(.0, distribution.pair_counts[annulus] - margin) / expected;
+                distribution.upper_bounds[annulus] = (distribution.pair_counts[annulus] + margin) / expected;
+            }
+        }
+        distributions.push_back(distribution);
+    }
+
+    return distributions;
+}
+
+void RadialDistributionAnalyzer::write(const RadialDistribution & p_distribution, std::ostream & p_stream)
+{
+    p_stream << "r_min,r_max,pair_count,value,lower_bound,upper_bound\n";
+    for(int annulus(0); annulus < p_distribution.values.size(); annulus++)
+    {
+        int r_min(p_distribution.r_min + annulus * p_distribution.r_diff);
+        p_stream << r_min << "," << r_min + p_distribution.r_diff << "," << p_distribution.pair_counts[annulus] << "," << p_distribution.values[annulus] << ","
+                 << p_distribution.lower_bounds[annulus] << "," << p_distribution.upper_bounds[annulus] << "\n";
+    }
+}
+
+bool RadialDistributionAnalyzer::write(const std::vector<RadialDistribution> & p_distributions, const QString & p_directory)
+{
+    bool success(true);
+    for(const RadialDistribution & distribution : p_distributions)
+    {
+        QString filename(QString("%1/%2_%3.csv").arg(p_directory).arg(distribution.reference_id).arg(distribution.target_id));
+        std::ofstream file(filename.toStdString().c_str(), std::ios::out | std::ios::trunc);
+        write(distribution, file);
+        success = success && file.good();
+    }
+    return success;
+}
+
+/***********
+ * PRIVATE *
+ ***********/
+RadialDistributionAnalyzer::CategoryGrid RadialDistributionAnalyzer::build_grid(const std::vector<Point> & p_points) const
+{
+    CategoryGrid grid{std::vector<Point>(p_points.size()), std::vector<int>(m_columns * m_rows + 1, 0), .0f, .0, .0};
+
+    // Counting sort on the cell index
+    std::vector<int> cells(p_points.size());
+    for(int i(0); i < p_points.size(); i++)
+    {
+        const Point & point(p_points[i]);
+        int column(std::min(m_columns-1, std::max(0, point.center.x() / _CELL_SIZE)));
+        int row(std::min(m_rows-1, std::max(0, point.center.y() / _CELL_SIZE)));
+        cells[i] = row * m_columns + column;
+        grid.cell_starts[cells[i]+1]++;
+
+        grid.max_radius = std::max(grid.max_radius, point.radius);
+        grid.radius_sum += point.radius;
+        grid.squared_radius_sum += point.radius * point.radius;
+    }
+    for(int cell(0); cell < m_columns * m_rows; cell++)
+        grid.cell_starts[cell+1] += grid.cell_starts[cell];
+
+    std::vector<int> insert_positions(grid.cell_starts.begin(), grid.cell_starts.end()-1);
+    for(int i(0); i < p_points.size(); i++)
+        grid.points[insert_positions[cells[i]]++] = p_points[i];
+
+    return grid;
+}
+
+/**
+ * Without budget, or with one at least as large as the category, one exhaustive stratum per band of _TILE_ROWS rows.
+ * Otherwise the bands are merged into at most budget / 2 strata of similar population, each given two samples (for
+ * its variance) and the rest of the budget proportionally to its population, largest remainders first. The samples
+ * of all the strata add up to exactly the budget.
+ */
+std::vector<RadialDistributionAnalyzer::Stratum> RadialDistributionAnalyzer::stratify(const CategoryGrid & p_reference, int p_sample_budget) const
+{
+    std::vector<Stratum> strata;
+    int population(p_reference.points.size());
+    int tile_count((m_rows + _TILE_ROWS - 1) / _TILE_ROWS);
+    auto tile_start = [&](int p_tile) { return p_reference.cell_starts[std::min(m_rows, p_tile * _TILE_ROWS) * m_columns]; };
+
+    if(p_sample_budget <= 0 || p_sample_budget >= population)
+    {
+        for(int tile(0); tile < tile_count; tile++)
+        {
+            int tile_population(tile_start(tile+1) - tile_start(tile));
+            strata.push_back(Stratum{tile * _TILE_ROWS, std::min(m_rows, (tile+1) * _TILE_ROWS), tile_population, tile_population});
+        }
+        return strata;
+    }
+
+    // Merge consecutive bands, a stratum being closed once it reaches its share of the population
+    int max_strata(std::max(1, p_sample_budget / 2));
+    int from_tile(0);
+    for(int tile(0); tile < tile_count; tile++)
+    {
+        int stratum_population(tile_start(tile+1) - tile_start(from_tile));
+        bool last(tile == tile_count-1);
+        if(last || (stratum_population > 0 && tile_start(tile+1) * (long long) max_strata >= (strata.size()+1) * (long long) population))
+        {
+            if(stratum_population > 0 || strata.empty())
+                strata.push_back(Stratum{from_tile * _TILE_ROWS, std::min(m_rows, (tile+1) * _TILE_ROWS), stratum_population, 0});
+            else // Trailing empty bands
+                strata.back().to_row = m_rows;
+            from_tile = tile+1;
+        }
+    }
+
+    // Minimums, then the remainder proportionally
+    int remainder(p_sample_budget);
+    for(Stratum & stratum : strata)
+    {
+        stratum.samples = std::min(remainder, std::min(2, stratum.population));
+        remainder -= stratum.samples;
+    }
+    int remainder_to_distribute(remainder);
+    std::vector<std::pair<double,int> > fractions; // Fractional part of the share, stratum index
+    for(int stratum_idx(0); stratum_idx < strata.size() && remainder > 0; stratum_idx++)
+    {
+        Stratum & stratum(strata[stratum_idx]);
+        double share(((double) remainder_to_distribute) * stratum.population / population);
+        int extra(std::min(std::min((int) share, stratum.population - stratum.samples), remainder));
+        stratum.samples += extra;
+        remainder -= extra;
+        fractions.push_back(std::make_pair(share - (int) share, stratum_idx));
+    }
+    std::stable_sort(fractions.begin(), fractions.end(), [](const std::pair<double,int> & lhs, const std::pair<double,int> & rhs) {
+        return lhs.first > rhs.first;
+    });
+    // Strata filled up by their share leave room elsewhere as the budget is below the population
+    while(remainder > 0)
+    {
+        int given(0);
+        for(const std::pair<double,int> & fraction : fractions)
+        {
+            Stratum & stratum(strata[fraction.second]);
+            if(remainder > 0 && stratum.samples < stratum.population)
+            {
+                stratum.samples++;
+                remainder--;
+                given++;
+            }
+        }
+        if(given == 0)
+            break;
+    }
+
+    return strata;
+}
+
+// Counts the pairs of the references sampled in the stratum
+void RadialDistributionAnalyzer::count_pairs(const CategoryGrid & p_reference, const CategoryGrid & p_target, bool p_same_category,
+                                             const Stratum & p_stratum, std::uint64_t p_sampling_key, StratumCounts & p_counts) const
+{
+    int first_point(p_reference.cell_starts[p_stratum.from_row * m_columns]);
+
+    p_counts.population = p_stratum.population;
+    p_counts.samples = p_stratum.samples;
+    if(p_counts.samples == 0)
+        return;
+
+    double stride(((double) p_counts.population) / p_counts.samples);
+    double offset(RandomStream(p_sampling_key).uniformFloat() * stride);
+
+    double target_radius_mean(p_target.points.empty() ? .0 : p_target.radius_sum / p_target.points.size());
+    std::vector<int> reference_counts(p_counts.sums.size());
+    for(int sample(0); sample < p_counts.samples; sample++)
+    {
+        int ref_idx(p_counts.samples == p_counts.population ? first_point + sample : first_point + (int) (offset + sample * stride));
+        const Point & reference(p_reference.points[ref_idx]);
+        std::fill(reference_counts.begin(), reference_counts.end(), 0);
+        float reach(m_r_max + reference.radius + p_target.max_radius); // Between centers
+
+        int from_column(std::max(0, (int) std::floor((reference.center.x() - reach) / _CELL_SIZE)));
+        int to_column(std::min(m_columns-1, (int) std::floor((reference.center.x() + reach) / _CELL_SIZE)));
+        int from_row(std::max(0, (int) std::floor((reference.center.y() - reach) / _CELL_SIZE)));
+        int to_row(std::min(m_rows-1, (int) std::floor((reference.center.y() + reach) / _CELL_SIZE)));
+
+        for(int row(from_row); row <= to_row; row++)
+        {
+            // The cells of a row are contiguous
+            int from(p_target.cell_starts[row * m_columns + from_column]);
+            int to(p_target.cell_starts[row * m_columns + to_column + 1]);
+            for(int target_idx(from); target_idx < to; target_idx++)
+            {
+                if(p_same_category && target_idx == ref_idx)
+                    continue;
+
+                const Point & target(p_target.points[target_idx]);
+                float dx(target.center.x() - reference.center.x());
+                float dy(target.center.y() - reference.center.y());
+                float distance(std::max(.0f, std::sqrt(dx*dx + dy*dy) - reference.radius - target.radius));
+                if(distance < m_r_min || distance >= m_r_max)
+                    continue;
+
+                int annulus((distance - m_r_min) / m_r_diff);
+                if(annulus < reference_counts.size())
+                    reference_counts[annulus]++;
+            }
+        }
+
+        // Annuli measured from the middle of each, for a target of average radius
+        for(int annulus(0); annulus < reference_counts.size(); annulus++)
+        {
+            double count(reference_counts[annulus]);
+            if(count > 0)
+                count *= edge_correction(reference.center, reference.radius + target_radius_mean + m_r_min + (annulus + .5) * m_r_diff);
+            p_counts.sums[annulus] += count;
+            p_counts.squared_sums[annulus] += count * count;
+        }
+    }
+}
+
+/**
+ * Inverse of the share of the circle centered on p_center lying inside the area. Each border closer than the radius
+ * cuts an arc of 2 acos(d / r) off the circle, two of these arcs overlapping when the corner they meet at is within the
+ * circle.
+ */
+double RadialDistributionAnalyzer::edge_correction(const QPoint & p_center, double p_radius) const
+{
+    double left(std::max(0, p_center.x())), right(std::max(0, m_area_width - p_center.x()));
+    double top(std::max(0, p_center.y())), bottom(std::max(0, m_area_height - p_center.y()));
+    if(p_radius <= std::min(std::min(left, right), std::min(top, bottom)))
+        return 1;
+
+    auto arc = [p_radius](double p_distance) { return p_distance < p_radius ? std::acos(p_distance / p_radius) : .0; };
+    auto corner_overlap = [p_radius, &arc](double p_horizontal_distance, double p_vertical_distance) -> double {
+        if(p_horizontal_distance * p_horizontal_distance + p_vertical_distance * p_vertical_distance >= p_radius * p_radius)
+            return .0;
+        return arc(p_horizontal_distance) + arc(p_vertical_distance) - M_PI/2;
+    };
+
+    double outside(2 * (arc(left) + arc(right) + arc(top) + arc(bottom)) -
+                   corner_overlap(left, top) - corner_overlap(right, top) - corner_overlap(left, bottom) - corner_overlap(right, bottom));
+    double inside(2 * M_PI - outside);
+
+    return inside > 0 ? 2 * M_PI / inside : 1;
+}
+
+/**
+ * Pair count expected for the annulus if the targets were spread uniformly over the area. For a reference of
+ * radius rr and a target of radius rt the annulus [a,b) spans center distances [rr+rt+a, rr+rt+b), or [0, rr+rt+b)
+ * for the first annulus when it includes the overlaps. Summed over the references and averaged over the targets.
+ */
+float RadialDistributionAnalyzer::expected_pairs(const CategoryGrid & p_reference, const CategoryGrid & p_target, bool p_same_category,
+                                                 int p_annulus) const
+{
+    double reference_count(p_reference.points.size());
+    double target_count(p_target.points.size());
+    double neighbour_count(p_same_category ? target_count - 1 : target_count);
+    if(reference_count == 0 || neighbour_count <= 0)
+        return 0;
+
+    double density(neighbour_count / ((double) m_area_width * m_area_height));
+    double target_radius_mean(p_target.radius_sum / target_count);
+    double target_squared_radius_mean(p_target.squared_radius_sum / target_count);
+
+    // Sum over the references of the mean over the targets of (rr + rt + x)^2
+    auto squared_outer_radii = [&](double x) {
+        return p_reference.squared_radius_sum + 2*x*p_reference.radius_sum + reference_count*x*x +
+                2*target_radius_mean*(p_reference.radius_sum + reference_count*x) + reference_count*target_squared_radius_mean;
+    };
+
+    double inner(m_r_min + p_annulus * m_r_diff);
+    double area(squared_outer_radii(inner + m_r_diff));
+    if(inner > 0)
+        area -= squared_outer_radii(inner);
+
+    return density * M_PI * area;
+}
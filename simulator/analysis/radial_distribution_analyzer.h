@@ -0,0 +1,103 @@
+#ifndef RADIAL_DISTRIBUTION_ANALYZER_H
+#define RADIAL_DISTRIBUTION_ANALYZER_H
+
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <ostream>
+#include <QPoint>
+#include <QString>
+
+class ThreadPool;
+
+struct RadialDistribution{
+    int reference_id;
+    int target_id;
+    int r_min, r_diff; // Annulus i spans [r_min + i*r_diff, r_min + (i+1)*r_diff)
+    std::vector<double> pair_counts; // Per annulus. Estimated for all the references when they are sampled
+    std::vector<float> values; // Pair correlation per annulus. 1 --> no interaction, < 1 --> inhibition, > 1 --> clustering
+    std::vector<float> lower_bounds, upper_bounds; // 95% confidence interval of the values. Equal to them when exact
+    int reference_count;
+    int sampled_reference_count;
+};
+
+/**
+ * In-process pair correlation (radial distribution) of plant canopies. Distances are measured between canopy
+ * edges, overlapping canopies falling in the first annulus, and binned in annuli of r_diff from r_min to r_max.
+ * Pair counts are edge corrected (Ripley's isotropic correction): the pairs of a reference near the borders of the
+ * area are weighted by the inverse of the share of the annulus lying inside the area.
+ * Points are bucketed in a uniform grid so only the cells within reach of each point are visited. Work is split
+ * across category pairs and bands of grid rows.
+ *
+ * Approximate mode: only a sample of at most the budget references of each category is analysed, the targets being
+ * complete. The sample is stratified by bands of grid rows, allocated proportionally, and drawn systematically from
+ * a random offset within each stratum (plants are sorted by cell, so it is spread over the stratum). Pair counts
+ * are estimated with the stratified estimator and its variance gives the confidence intervals. A budget at least as
+ * large as the category gives the exact result.
+ */
+class RadialDistributionAnalyzer
+{
+public:
+    struct Point{
+        QPoint center; // cm
+        float radius; // cm
+    };
+    typedef std::map<int, std::vector<Point> > Categories; // Category id --> points
+
+    RadialDistributionAnalyzer(int p_r_min, int p_r_max, int p_r_diff, int p_area_width, int p_area_height);
+
+    /**
+     * Each category is analysed against itself and every category preceding it in the priority order.
+     * Categories missing from the priority order are ignored.
+     * p_sample_budget: maximum number of references analysed per category, 0 --> all (exact)
+     */
+    std::vector<RadialDistribution> analyze(const Categories & p_categories, const std::vector<int> & p_priority_sorted_ids,
+                                            ThreadPool & p_thread_pool, int p_sample_budget = 0) const;
+
+    // CSV, one line per annulus
+    static void write(const RadialDistribution & p_distribution, std::ostream & p_stream);
+    // One <reference id>_<target id>.csv file per distribution. Returns false if any could not be written
+    static bool write(const std::vector<RadialDistribution> & p_distributions, const QString & p_directory);
+
+    int getAnnulusCount() const;
+
+    static const int _CELL_SIZE; // cm
+    static const int _TILE_ROWS; // Grid rows per task and stratum, merged when the budget is too small for them
+    static const float _CONFIDENCE_Z; // Standard score of the confidence intervals
+
+private:
+    struct CategoryGrid{
+        std::vector<Point> points; // Sorted by cell, row major
+        std::vector<int> cell_starts; // Index of the first point of each cell, plus the point count
+        float max_radius;
+        double radius_sum;
+        double squared_radius_sum;
+    };
+
+    struct Stratum{
+        int from_row, to_row; // Grid rows [from_row, to_row)
+        int population;
+        int samples;
+    };
+
+    // Pair counts of the references sampled in a stratum
+    struct StratumCounts{
+        int population;
+        int samples;
+        std::vector<double> sums; // Per annulus
+        std::vector<double> squared_sums; // Per annulus, of the count of each reference
+    };
+
+    CategoryGrid build_grid(const std::vector<Point> & p_points) const;
+    std::vector<Stratum> stratify(const CategoryGrid & p_reference, int p_sample_budget) const;
+    void count_pairs(const CategoryGrid & p_reference, const CategoryGrid & p_target, bool p_same_category,
+                     const Stratum & p_stratum, std::uint64_t p_sampling_key, StratumCounts & p_counts) const;
+    double edge_correction(const QPoint & p_center, double p_radius) const;
+    float expected_pairs(const CategoryGrid & p_reference, const CategoryGrid & p_target, bool p_same_category, int p_annulus) const;
+
+    int m_r_min, m_r_max, m_r_diff;
+    int m_area_width, m_area_height;
+    int m_columns, m_rows;
+};
+
+#endif // RADIAL_DISTRIBUTION_ANALYZER_H
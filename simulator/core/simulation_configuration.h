@@ -2,8 +2,9 @@
 #define SIMULATION_CONFIGURATION_H
 
 #include <map>
-#include <QImage>
+#include <vector>
 #include <array>
+#include <chrono>
 
 class SimulationConfiguration {
 public:
@@ -15,8 +16,10 @@ public:
 
     int m_duration;
     bool m_seeding_enabled;
+    int m_thread_count; // Threads evaluating the plants. 0 --> One per core
+    unsigned int m_seed; // Same seed and configuration --> same simulation, whatever the thread count
 
-    SimulationConfiguration() {}
+    SimulationConfiguration() : m_thread_count(0), m_seed(randomSeed()) {}
 
     ~SimulationConfiguration() {}
 
@@ -26,15 +29,24 @@ public:
                             std::vector<int> illumination,
                             std::vector<int> temperature,
                             int duration,
-                            bool enable_seeding) :
+                            bool enable_seeding,
+                            int thread_count = 0,
+                            unsigned int seed = randomSeed()) :
         m_plants_to_generate(plants_to_generate),
         m_slope(slope),
         m_humidity(humidity),
         m_illumination(illumination),
         m_temperature(temperature),
         m_duration(duration),
-        m_seeding_enabled(enable_seeding)
+        m_seeding_enabled(enable_seeding),
+        m_thread_count(thread_count),
+        m_seed(seed)
     {}
+
+    static unsigned int randomSeed()
+    {
+        return (unsigned int) std::chrono::system_clock::now().time_since_epoch().count();
+    }
 };
 
 #endif //SIMULATION_CONFIGURATION_H
@@ -7,27 +7,30 @@
 #include "../../utils/utils.h"
 #include "../plants/plant.h"
 #include "../../utils/callback_listener.h"
+#include "../../utils/trace_recorder.h"
 
 #include <QDebug>
 
-#include <chrono>
-typedef std::chrono::high_resolution_clock Clock;
 
-
-static QRgb s_black_color_rgb(QColor(Qt::GlobalColor::black).rgb());
 const int SimulatorManager::_AREA_WIDTH_HEIGHT = 10000;
-SimulatorManager::SimulatorManager() : m_time_keeper(),
-    m_plant_storage(SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT),
+SimulatorManager::SimulatorManager() : SimulatorManager(SpecieTable::load())
+{
+
+}
+
+SimulatorManager::SimulatorManager(std::shared_ptr<const SpecieTable> p_specie_table) : m_time_keeper("simulation_timer"),
     m_environment_mgr(SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT),
-    m_plant_factory(SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT),
+    m_plant_factory(SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT, p_specie_table),
+    m_plant_storage(SimulatorManager::_AREA_WIDTH_HEIGHT, SimulatorManager::_AREA_WIDTH_HEIGHT, m_plant_factory.getSpecieTable()),
     m_elapsed_months(0), m_state(Stopped), m_snapshot_creator_thread(nullptr), m_statistical_snapshot_thread(nullptr),
-    m_stopping(false), m_generate_rendering_data(true)
+    m_stopping(false), m_discard_month(false), m_generate_rendering_data(true)
 {
     m_time_keeper.addListener(this);
 }
 
 SimulatorManager::~SimulatorManager()
 {
+    m_time_keeper.stop(); // The timer outlives the simulation data
     if(m_snapshot_creator_thread)
     {
         m_snapshot_creator_thread->join();
@@ -45,10 +48,13 @@ void SimulatorManager::add_plant(Plant p_plant)
     if(!m_plant_storage.isPlantAtLocation(p_plant.m_center_position))
     {
         m_plant_storage.add(p_plant);
+        m_profiler.addCount(SimulationProfiler::PlantsBorn, 1);
         m_environment_mgr.updateEnvironment(p_plant.m_center_position, p_plant.getCanopyWidth(), p_plant.getHeight(), p_plant.getRootSize(),
                                             p_plant.m_unique_id, p_plant.getMinimumSoilHumidityRequirement()); // Update resources in environment
 
-        emit newPlant(p_plant.m_specie_name, p_plant.getColor());
+#ifndef HEADLESS_MODE
+        emit newPlant(p_plant.getSpecieName(), p_plant.getColor());
+#endif
     }
 }
 
@@ -60,6 +66,9 @@ void SimulatorManager::add_plant(Plant p_plant)
 void SimulatorManager::setConfiguration(SimulationConfiguration configuration)
 {
     m_configuration = configuration;
+    m_random_streams = RandomStreams(configuration.m_seed);
+    m_plant_factory.setRandomStreams(m_random_streams);
+    m_plant_storage.setThreadCount(configuration.m_thread_count);
     m_environment_mgr.setEnvironmentProperties(configuration.m_slope,
                                                configuration.m_humidity,
                                                configuration.m_illumination,
@@ -89,6 +98,7 @@ void SimulatorManager::start( SimulationConfiguration configuration)
 
     m_state = Running;
     m_stopping.store(false);
+    m_discard_month.store(false);
     m_time_keeper.start();
 }
 #else
@@ -97,7 +107,6 @@ void SimulatorManager::start( SimulationConfiguration configuration, ProgressLis
 
     SimulatorManager sm;
     sm.setConfiguration(configuration);
-    auto start(Clock::now());
     int elapsed_months(0);
     while((elapsed_months = sm.getElapsedMonths()) < configuration.m_duration)
     {
@@ -108,8 +117,6 @@ void SimulatorManager::start( SimulationConfiguration configuration, ProgressLis
     progress_listener->progressUpdate("Generating statistical snapshot... This can take some time.");
 
     sm.generateStatisticalSnapshot();
-    auto time(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
-    qCritical() << "SIMULATION TIME --> " << time << "ms";
     progress_listener->complete();
 }
 #endif
@@ -121,6 +128,7 @@ void SimulatorManager::resume()
     m_time_keeper.start();
 }
 
+// Returns once the month in progress, if any, has been cancelled or completed
 void SimulatorManager::pause()
 {
     m_state = Paused;
@@ -128,34 +136,37 @@ void SimulatorManager::pause()
     m_time_keeper.stop();
 }
 
+// Returns once the month in progress, if any, has been abandoned
 void SimulatorManager::stop()
 {
     m_state = Stopped;
     m_stopping.store(true);
+    m_discard_month.store(true);
     m_time_keeper.stop();
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(250)); // Wait a delay to ensure all data processing has stopped from the previous trigger
-
 #ifdef GUI_MODE
-    m_plant_rendering_data.lock();
-    m_plant_rendering_data.clear();
-    m_plant_rendering_data.unlock();
+    m_plant_rendering_data.getBackBuffer().clear();
+    m_plant_rendering_data.publish();
 #endif
 
     m_plant_storage.clear();
     m_environment_mgr.reset();
+    m_profiler.clear();
     m_elapsed_months = 0;
     emit updated(0);
 }
 
+/*
+ * Cancellation checkpoints: while its plants are being evaluated, a month can be cancelled as a whole and is
+ * run again on resume. Past that point, it is only abandoned when stopping, as the state is then discarded.
+ */
 void SimulatorManager::trigger()
 {
-#ifdef GUI_MODE
     if(m_stopping.load())
         return;
-#endif
-    auto start(Clock::now());
+    TraceRecorder::Scope month_trace("month");
     m_elapsed_months++;
+    m_profiler.beginMonth(m_elapsed_months);
 
     /*
      * ITERATION # 1:
@@ -169,33 +180,59 @@ void SimulatorManager::trigger()
     // Update all the plants
     std::vector<Plant> surviving_plants;
     std::vector<Plant> deceased_plants;
-    m_plant_storage.update(m_environment_mgr, surviving_plants, deceased_plants);
+    {
+        SimulationProfiler::ScopedPhase phase(m_profiler, SimulationProfiler::PlantUpdate);
+        if(!m_plant_storage.update(m_environment_mgr, m_random_streams, m_elapsed_months, surviving_plants, deceased_plants, true, &m_stopping))
+        {
+            m_elapsed_months--;
+            return;
+        }
+    }
+    m_profiler.addCount(SimulationProfiler::PlantsEvaluated, surviving_plants.size() + deceased_plants.size());
+    m_profiler.addCount(SimulationProfiler::PlantsKilled, deceased_plants.size());
+
+    if(m_discard_month.load())
+        return;
 
     // Update the environment
-    for(Plant & p : surviving_plants)
     {
-        m_environment_mgr.updateEnvironment(p.m_center_position, p.getCanopyWidth(), p.getHeight(),
-                                            p.getRootSize(), p.m_unique_id, p.getMinimumSoilHumidityRequirement());
+        SimulationProfiler::ScopedPhase phase(m_profiler, SimulationProfiler::EnvironmentUpdate);
+        for(Plant & p : surviving_plants)
+        {
+            m_environment_mgr.updateEnvironment(p.m_center_position, p.getCanopyWidth(), p.getHeight(),
+                                                p.getRootSize(), p.m_unique_id, p.getMinimumSoilHumidityRequirement());
+        }
     }
-    for(Plant & p : deceased_plants)
+    if(m_discard_month.load())
+        return;
+
     {
-        m_environment_mgr.updateEnvironment(p.m_center_position, p.getCanopyWidth(), p.getHeight(),
-                                            p.getRootSize(), p.m_unique_id, p.getMinimumSoilHumidityRequirement());
-        m_environment_mgr.remove(p.m_center_position, p.getCanopyWidth(), p.getRootSize(), p.m_unique_id);
-        emit removedPlant(p.m_specie_name, plant_status_to_string(p.getStatus()));
+        SimulationProfiler::ScopedPhase phase(m_profiler, SimulationProfiler::DeceasedRemoval);
+        for(Plant & p : deceased_plants)
+        {
+            m_environment_mgr.updateEnvironment(p.m_center_position, p.getCanopyWidth(), p.getHeight(),
+                                                p.getRootSize(), p.m_unique_id, p.getMinimumSoilHumidityRequirement());
+            m_environment_mgr.remove(p.m_center_position, p.getCanopyWidth(), p.getRootSize(), p.m_unique_id);
+            emit removedPlant(p.getSpecieName(), plant_status_to_string(p.getStatus()));
+        }
     }
 
     // Seeding
     if(m_configuration.m_seeding_enabled && m_elapsed_months % 12 == 6)
     {
+        SimulationProfiler::ScopedPhase phase(m_profiler, SimulationProfiler::Seeding);
         std::set<int> species(m_plant_storage.getSpecieIds());
 
         for(int specie_id : species)
         {
+            if(m_discard_month.load())
+                return;
+
             int specie_seed_count(m_plant_factory.getSpecieProperties(specie_id).seeding_properties.seed_count);
+            RandomStream random_stream(m_random_streams.stream(RandomStreams::Seeding, specie_id, m_elapsed_months));
             if(m_plant_storage.containsSpecie(specie_id)) // Use existing plants to seed
             {
-                std::vector<Plant> seeding_plants(m_plant_storage.getOnePlantPerCell(specie_id));
+                std::vector<Plant> seeding_plants(m_plant_storage.getOnePlantPerCell(specie_id, random_stream));
 
                 auto plant_it(seeding_plants.begin());
 
@@ -205,7 +242,7 @@ void SimulatorManager::trigger()
                 while(seed_count++ < specie_seed_count)
                 {
                     Plant & seeding_plant (*plant_it);
-                    QPoint position (seeding_plant.seed(1).at(0));
+                    QPoint position (seeding_plant.seed(1, random_stream).at(0));
                     if(position.x() >= 0 && position.x() < SimulatorManager::_AREA_WIDTH_HEIGHT &&
                         position.y() >= 0 && position.y() < SimulatorManager::_AREA_WIDTH_HEIGHT)
                     {
@@ -219,20 +256,21 @@ void SimulatorManager::trigger()
             else // spawn new plants
             {
                 int n_planted(0);
-                const SpecieProperties specie_properties (m_plant_factory.getSpecieProperties(specie_id));
+                const SpecieProperties & specie_properties (m_plant_factory.getSpecieProperties(specie_id));
                 if(specie_properties.illumination_properties.min_illumination == 0 && m_elapsed_months > 240)
                 {
                     // shade loving - spawn half at existing plant locations (shaded)
-                    std::vector<Plant> plants (m_plant_storage.getPlants());
+                    std::vector<Plant> plants (m_plant_storage.getRandomPlants(specie_seed_count/2, random_stream));
                     if(plants.size() > 0)
                     {
                         for(; n_planted < specie_seed_count/2; n_planted++)
                         {
-                            // Select a random plant
-                            Plant & random_plant(*(plants.begin() + (rand()%plants.size())));
+                            const Plant & random_plant(plants[n_planted]);
                             QPoint location(Utils::getRandomPointInCircle(random_plant.m_center_position,
-                                                                                std::max(1.0f,random_plant.getCanopyWidth()/2.f)));
-                            if(location.x() < _AREA_WIDTH_HEIGHT && location.y() < _AREA_WIDTH_HEIGHT)
+                                                                                std::max(1.0f,random_plant.getCanopyWidth()/2.f),
+                                                                                random_stream));
+                            if(location.x() >= 0 && location.x() < _AREA_WIDTH_HEIGHT &&
+                                location.y() >= 0 && location.y() < _AREA_WIDTH_HEIGHT)
                                 add_plant(m_plant_factory.generate(specie_id, location));
                         }
                     }
@@ -243,82 +281,42 @@ void SimulatorManager::trigger()
         }
     }
 
+    if(m_discard_month.load())
+        return;
+
 #ifdef GUI_MODE
     if(m_generate_rendering_data.load())
+    {
+        SimulationProfiler::ScopedPhase phase(m_profiler, SimulationProfiler::RenderingData);
         refresh_rendering_data();
+    }
 #endif
-    emit updated(month);    
-//    auto time(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
-
-//    // PLANT COUNT BASED TIMING
-//    {
-//        int key(m_plant_storage.getPlantCount()/1000.f);
-//        auto it(_plant_count_based_timing.find(key));
-//        if(it == _plant_count_based_timing.end())
-//        {
-//            TimeAndCount time_and_count;
-//            time_and_count.time = time;
-//            time_and_count.count = 1;
-//            _plant_count_based_timing.emplace(key, time_and_count);
-//        }
-//        else
-//        {
-//            it->second.time += time;
-//            it->second.count++;
-//        }
-//    }
-
-//    // PLANTS PER MONTH
-//    {
-//        _plant_count_per_month.emplace(m_elapsed_months, m_plant_storage.getPlantCount());
-//    }
-
-//    // ELAPSED TIME BASED TIMING
-//    {
-//        _elapsed_months_based_timing.emplace(m_elapsed_months, time);
-//    }
-
-//    // PLANT AVERAGE SIZE
-//    {
-//        std::map<int, float> specie_avg_sizes;
-//        std::map<int, int> specie_count;
-
-//        for(int specie_id : m_plant_storage.getSpecieIds())
-//        {
-//            specie_avg_sizes[specie_id] = 0;
-//            specie_count[specie_id] = 0;
-//        }
-
-//        std::vector<Plant> plants(m_plant_storage.getPlants());
-//        for(Plant & p : plants)
-//        {
-//            specie_avg_sizes[p.m_specie_id] += p.getCanopyWidth();
-//            specie_count[p.m_specie_id]++;
-//        }
-
-//        for(auto it(specie_count.begin()); it != specie_count.end(); it++)
-//        {
-//            _specie_average_size[it->first].push_back(((float)specie_avg_sizes[it->first]) / it->second);
-//        }
-//    }
-
-//    if(m_elapsed_months == 1200)
-//    {
-////        std::cout << "******************SPECIE AVERAGE SIZE*************" << std::endl;
-////        for(auto it(_specie_average_size.begin()); it != _specie_average_size.end(); it++)
-////        {
-////            std::cout << "SPECIE --> " << it->first << std::endl;
-////            for(int i(0); i < it->second.size(); i++)
-////                std::cout << (i+1) << " , " << it->second.at(i) << std::endl;
-
-////        }
-//        std::cout << "******************PLANT COUNT BASED*************" << std::endl;
-//        for(auto it(_plant_count_based_timing.begin()); it != _plant_count_based_timing.end(); it++)
-//            std::cout << it->first << ", " << (it->second.time/(float)it->second.count) << std::endl;
-//////        std::cout << "******************MONTH BASED*************" << std::endl;
-//////        for(auto it(_elapsed_months_based_timing.begin()); it != _elapsed_months_based_timing.end(); it++)
-//////            std::cout << it->first << ", " << _plant_count_per_month[it->first] << ", " << it->second << std::endl;
-//    }
+    m_environment_mgr.publishChangedCells();
+    m_profiler.addCount(SimulationProfiler::CellsTouched, m_environment_mgr.takeTouchedCellCount());
+    m_profiler.addLockWait(SimulationProfiler::PlantStorageLock, m_plant_storage.takeLockWaitTime());
+    m_profiler.endMonth();
+
+    emit updated(month);
+}
+
+int SimulatorManager::getPlantCount() const
+{
+    return m_plant_storage.getPlantCount();
+}
+
+std::map<int, int> SimulatorManager::getSpeciePlantCounts() const
+{
+    return m_plant_storage.getSpeciePlantCounts();
+}
+
+const SpecieTable & SimulatorManager::getSpecieTable() const
+{
+    return *m_plant_factory.getSpecieTable();
+}
+
+SimulationProfiler & SimulatorManager::getProfiler()
+{
+    return m_profiler;
 }
 
 void SimulatorManager::generate_rendering_data(bool generate)
@@ -327,7 +325,7 @@ void SimulatorManager::generate_rendering_data(bool generate)
 }
 
 #ifdef GUI_MODE
-const PlantRenderDataContainer& SimulatorManager::getPlantRenderingData()
+PlantRenderDataContainer & SimulatorManager::getPlantRenderingData()
 {
     return m_plant_rendering_data;
 }
@@ -340,6 +338,7 @@ const EnvironmentSpatialHashMap & SimulatorManager::getEnvironmentRenderingData(
 
 void SimulatorManager::setMonthlyTriggerFrequency(int p_frequency)
 {
+    m_time_keeper.setMode(p_frequency > 0 ? TimeManager::Periodic : TimeManager::AsFastAsPossible);
     m_time_keeper.setUnitTime(p_frequency);
 }
 
@@ -370,19 +369,19 @@ QString SimulatorManager::plant_status_to_string(Plant::PlantStatus status)
 #ifdef GUI_MODE
 void SimulatorManager::refresh_rendering_data()
 {
-    m_plant_rendering_data.lock();
-
-    m_plant_rendering_data.clear();
+    std::vector<PlantRenderingData> & plants(m_plant_rendering_data.getBackBuffer());
+    plants.clear();
 
     for(Plant & p : m_plant_storage.getSortedPlants(SortingCriteria::Height))
     {
-        m_plant_rendering_data.push_back( PlantRenderingData(p.m_specie_name, p.getColor(), p.m_center_position, p.getHeight(), p.getCanopyWidth(), p.getRootSize()));
+        plants.push_back( PlantRenderingData(p.m_specie->m_index, p.m_specie->m_rgb, p.m_center_position, p.getCanopyWidth(), p.getRootSize()));
     }
 
-    m_plant_rendering_data.unlock();
+    m_plant_rendering_data.publish();
 }
 #endif
 
+#ifndef HEADLESS_MODE
 void SimulatorManager::generateSnapshot()
 {
     if(m_snapshot_creator_thread)
@@ -391,16 +390,27 @@ void SimulatorManager::generateSnapshot()
         delete m_snapshot_creator_thread;
     }
 
-    m_snapshot_creator_thread = new std::thread(&PlantStorage::generateSnapshot, &m_plant_storage, true);
+    m_snapshot_creator_thread = new std::thread(&PlantStorage::generateSnapshot, &m_plant_storage, m_snapshot_settings, true);
 }
 
-void SimulatorManager::generateStatisticalSnapshot()
+void SimulatorManager::setSnapshotSettings(const SnapshotSettings & p_settings)
+{
+    m_snapshot_settings = p_settings;
+}
+
+const SnapshotSettings & SimulatorManager::getSnapshotSettings() const
+{
+    return m_snapshot_settings;
+}
+#endif
+
+void SimulatorManager::generateStatisticalSnapshot(int p_sample_budget)
 {
     m_plant_storage.generateStatisticalSnapshot(m_environment_mgr.getSlope(), m_environment_mgr.getHumidities(), m_environment_mgr.getIlluminations(),
-                                                m_environment_mgr.getTemperatures(), m_elapsed_months);
+                                                m_environment_mgr.getTemperatures(), m_elapsed_months, p_sample_budget);
 }
 
-void SimulatorManager::generateStatisticalSnapshot(CallbackListener * completion_listener)
+void SimulatorManager::generateStatisticalSnapshot(CallbackListener * completion_listener, int p_sample_budget)
 {
     if(m_statistical_snapshot_thread)
     {
@@ -410,5 +420,5 @@ void SimulatorManager::generateStatisticalSnapshot(CallbackListener * completion
 
     m_statistical_snapshot_thread =
             new std::thread(&PlantStorage::generateStatisticalSnapshot, &m_plant_storage, m_environment_mgr.getSlope(), m_environment_mgr.getHumidities(), m_environment_mgr.getIlluminations(),
-                    m_environment_mgr.getTemperatures(), m_elapsed_months, completion_listener, true);
+                    m_environment_mgr.getTemperatures(), m_elapsed_months, p_sample_budget, completion_listener, true);
 }
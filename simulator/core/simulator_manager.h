@@ -7,6 +7,7 @@
 #include "../../resources/environment_manager.h"
 #include "../plants/plant.h"
 #include "simulation_configuration.h"
+#include "../../utils/simulation_profiler.h"
 
 #ifdef GUI_MODE
 #include "../../data_holders/plant_rendering_data_container.h"
@@ -19,11 +20,6 @@
 #include <uchar.h>
 class CallbackListener;
 
-struct TimeAndCount{
-    int time;
-    int count;
-};
-
 class SimulatorManager : public QObject, public TimeManager::TimeListener
 {
     Q_OBJECT
@@ -42,18 +38,28 @@ public:
     };
 
     SimulatorManager();
+    SimulatorManager(std::shared_ptr<const SpecieTable> p_specie_table); // Specie table shared with other simulations
     ~SimulatorManager();
 
     int getElapsedMonths() { return m_elapsed_months; }
+    int getPlantCount() const;
+    std::map<int, int> getSpeciePlantCounts() const; // Specie id --> plant count
+    const SpecieTable & getSpecieTable() const;
+    SimulationProfiler & getProfiler(); // Disabled by default
 
-    void setMonthlyTriggerFrequency(int p_frequency);
+    void setMonthlyTriggerFrequency(int p_frequency); // ms, 0 --> months run back to back
 
     virtual void trigger();
 
     State getState() { return m_state; }
 
+#ifndef HEADLESS_MODE
+    void setSnapshotSettings(const SnapshotSettings & p_settings);
+    const SnapshotSettings & getSnapshotSettings() const;
+#endif
+
 #ifdef GUI_MODE
-    const PlantRenderDataContainer & getPlantRenderingData();
+    PlantRenderDataContainer & getPlantRenderingData(); // Read from the render timer thread only
     const EnvironmentSpatialHashMap & getEnvironmentRenderingData();
 #else
 static void start(SimulationConfiguration configuration, ProgressListener* progress_listener);
@@ -69,14 +75,19 @@ public slots:
     void pause();
     void resume();
     void stop();
+#ifndef HEADLESS_MODE
     void generateSnapshot();
-    void generateStatisticalSnapshot(CallbackListener * completion_listener);
-    void generateStatisticalSnapshot(); // non-asynchronous
+#endif
+    // p_sample_budget: plants analysed per specie, 0 --> all (exact)
+    void generateStatisticalSnapshot(CallbackListener * completion_listener, int p_sample_budget = 0);
+    void generateStatisticalSnapshot(int p_sample_budget = 0); // non-asynchronous analysis, see TrackerWriter::flush for the database write
     void generate_rendering_data(bool);
 
 signals:
     void updated(int);
+#ifndef HEADLESS_MODE
     void newPlant(QString name, QColor color);
+#endif
     void removedPlant(QString name, QString cause_of_death);
 
 private:
@@ -94,24 +105,25 @@ private:
 
     SimulationConfiguration m_configuration;
 
+    PlantFactory m_plant_factory;
     PlantStorage m_plant_storage;
+    RandomStreams m_random_streams; // Seeded by the configuration
+#ifndef HEADLESS_MODE
+    SnapshotSettings m_snapshot_settings;
+#endif
+    SimulationProfiler m_profiler;
 
     QString plant_status_to_string(Plant::PlantStatus status);
 
     int m_elapsed_months;
-    std::atomic<bool> m_stopping;
+    std::atomic<bool> m_stopping; // Cancels the month in progress if its plants are still being evaluated
+    std::atomic<bool> m_discard_month; // Set when stopping: the month in progress is abandoned at the next checkpoint
     State m_state;
 
-    PlantFactory m_plant_factory;
-
     std::thread * m_snapshot_creator_thread;
     std::thread * m_statistical_snapshot_thread;
 
     std::atomic<bool> m_generate_rendering_data;
-    std::map<int, std::vector<float> > _specie_average_size;
-    std::map<int, TimeAndCount> _plant_count_based_timing;
-    std::map<int, int> _plant_count_per_month;
-    std::map<int, int> _elapsed_months_based_timing;
 };
 
 #endif //SIMULATOR_MANAGER_H
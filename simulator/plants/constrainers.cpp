@@ -40,7 +40,7 @@ ConstrainersWrapper::~ConstrainersWrapper()
  * AGE CONSTRAINER *
  *******************/
 AgeConstrainer::AgeConstrainer(const AgeingProperties & p_ageing_properties) :
-    m_age(0), m_properties(p_ageing_properties)
+    m_properties(p_ageing_properties)
 {
     // Build the pre-prime linear equation
     {
@@ -65,16 +65,11 @@ AgeConstrainer::~AgeConstrainer()
 //    return *this;
 //}
 
-void AgeConstrainer::setAge(int p_age)
+int AgeConstrainer::getStrength(int p_age) const
 {
-    m_age = p_age;
-}
-
-int AgeConstrainer::getStrength() const
-{
-    if(m_age > m_properties.start_of_decline)
+    if(p_age > m_properties.start_of_decline)
     {
-        return m_ageing_equation.calculateY(m_age);
+        return m_ageing_equation.calculateY(p_age);
     }
     return Constrainer::_MAX_STRENGTH;
 }
@@ -83,7 +78,7 @@ int AgeConstrainer::getStrength() const
  * ILLUMINATION CONSTRAINER *
  ****************************/
 IlluminationConstrainer::IlluminationConstrainer(const IlluminationProperties & p_illumination_properties) :
-    m_daily_illumination(0), m_properties(p_illumination_properties)
+    m_properties(p_illumination_properties)
 {
     // Underexposure equation
     if(m_properties.prime_illumination.first > 0)
@@ -127,14 +122,9 @@ IlluminationConstrainer::~IlluminationConstrainer()
 //    return *this;
 //}
 
-void IlluminationConstrainer::setDailyIllumination(int p_daily_illumination)
-{
-    m_daily_illumination = p_daily_illumination;
-}
-
-bool IlluminationConstrainer::isUnderExposed()
+bool IlluminationConstrainer::isUnderExposed(int p_daily_illumination) const
 {
-    return m_daily_illumination < m_properties.prime_illumination.first;
+    return p_daily_illumination < m_properties.prime_illumination.first;
 }
 
 /**
@@ -142,13 +132,13 @@ bool IlluminationConstrainer::isUnderExposed()
  * @param p_ratio --> shadowed / all
  * @return
  */
-int IlluminationConstrainer::getStrength() const
+int IlluminationConstrainer::getStrength(int p_daily_illumination) const
 {
-    if(m_daily_illumination < m_properties.prime_illumination.first)
-        return m_underexposure_equation.calculateY(m_daily_illumination);
+    if(p_daily_illumination < m_properties.prime_illumination.first)
+        return m_underexposure_equation.calculateY(p_daily_illumination);
 
-    if(m_daily_illumination > m_properties.prime_illumination.second)
-        return m_overexposure_equation.calculateY(m_daily_illumination);
+    if(p_daily_illumination > m_properties.prime_illumination.second)
+        return m_overexposure_equation.calculateY(p_daily_illumination);
 
     return Constrainer::_MAX_STRENGTH;
 }
@@ -202,25 +192,20 @@ SoilHumidityConstrainer::~SoilHumidityConstrainer()
 //    return *this;
 //}
 
-int SoilHumidityConstrainer::getStrength() const
+int SoilHumidityConstrainer::getStrength(int p_soil_humidity) const
 {
-    if(m_soil_humidity < m_properties.prime_soil_humidity.first)
-        return m_drought_equation.calculateY(m_soil_humidity);
+    if(p_soil_humidity < m_properties.prime_soil_humidity.first)
+        return m_drought_equation.calculateY(p_soil_humidity);
 
-    if(m_soil_humidity > m_properties.prime_soil_humidity.second)
-        return m_flood_equation.calculateY(m_soil_humidity);
+    if(p_soil_humidity > m_properties.prime_soil_humidity.second)
+        return m_flood_equation.calculateY(p_soil_humidity);
 
     return Constrainer::_MAX_STRENGTH;
 }
 
-bool SoilHumidityConstrainer::isInDrought() const
+bool SoilHumidityConstrainer::isInDrought(int p_soil_humidity) const
 {
-    return m_soil_humidity < m_properties.prime_soil_humidity.first;
-}
-
-void SoilHumidityConstrainer::setSoilHumidity(int p_soil_humidity)
-{
-    m_soil_humidity = p_soil_humidity;
+    return p_soil_humidity < m_properties.prime_soil_humidity.first;
 }
 
 int SoilHumidityConstrainer::getMinimumPrimeSoilHumidity() const
@@ -261,25 +246,20 @@ TemperatureConstrainer::~TemperatureConstrainer()
 //    return *this;
 //}
 
-int TemperatureConstrainer::getStrength() const
+int TemperatureConstrainer::getStrength(int p_temp) const
 {
-    if(m_temperature < m_properties.prime_temp.first)
-        return m_chill_equation.calculateY(m_temperature);
+    if(p_temp < m_properties.prime_temp.first)
+        return m_chill_equation.calculateY(p_temp);
 
-    if(m_temperature > m_properties.prime_temp.second)
-        return m_warmth_equation.calculateY(m_temperature);
+    if(p_temp > m_properties.prime_temp.second)
+        return m_warmth_equation.calculateY(p_temp);
 
     return Constrainer::_MAX_STRENGTH;
 }
 
-void TemperatureConstrainer::setTemperature(int p_temp)
-{
-    m_temperature = p_temp;
-}
-
-bool TemperatureConstrainer::isTooCold() const
+bool TemperatureConstrainer::isTooCold(int p_temp) const
 {
-    return m_temperature < m_properties.prime_temp.first;
+    return p_temp < m_properties.prime_temp.first;
 }
 
 /*********
@@ -298,18 +278,13 @@ SlopeConstrainer::~SlopeConstrainer()
 
 }
 
-int SlopeConstrainer::getStrength() const
+int SlopeConstrainer::getStrength(int p_slope) const
 {
-    if(m_slope < m_properties.start_of_decline)
+    if(p_slope < m_properties.start_of_decline)
         return Constrainer::_MAX_STRENGTH;
 
-    if(m_slope > m_properties.max)
+    if(p_slope > m_properties.max)
         return Constrainer::_MIN_STRENGTH;
 
-    return m_slope_equation.calculateY(m_slope);
-}
-
-void SlopeConstrainer::setSlope(int p_slope)
-{
-    m_slope = p_slope;
+    return m_slope_equation.calculateY(p_slope);
 }
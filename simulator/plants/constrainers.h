@@ -13,7 +13,7 @@ public:
     static const int _MAX_STRENGTH;
 
     virtual ~Constrainer() {}
-    virtual int getStrength() const = 0;
+    virtual int getStrength(int p_value) const = 0;
 };
 
 /*******************
@@ -26,12 +26,9 @@ public:
     ~AgeConstrainer();
 //    AgeConstrainer & operator=(const AgeConstrainer& other);
 
-    virtual int getStrength() const ;
-
-    void setAge(int p_age);
+    virtual int getStrength(int p_age) const ;
 
 private:
-    int m_age;
     AgeingProperties m_properties;
     LinearEquation m_ageing_equation;
 };
@@ -46,17 +43,14 @@ public:
     ~IlluminationConstrainer();
 //    IlluminationConstrainer & operator=(const IlluminationConstrainer& other);
 
-    virtual int getStrength() const;
-
-    void setDailyIllumination(int p_daily_illumination);
+    virtual int getStrength(int p_daily_illumination) const;
 
-    bool isUnderExposed();
+    bool isUnderExposed(int p_daily_illumination) const;
 
 private:
     IlluminationProperties m_properties;
     LinearEquation m_underexposure_equation;
     LinearEquation m_overexposure_equation;
-    int m_daily_illumination; // in hours
 };
 
 /*****************
@@ -69,17 +63,15 @@ public:
     ~SoilHumidityConstrainer();
 //    SoilHumidityConstrainer & operator=(const SoilHumidityConstrainer& other);
 
-    virtual int getStrength() const;
-    bool isInDrought() const;
+    virtual int getStrength(int p_soil_humidity) const;
+    bool isInDrought(int p_soil_humidity) const;
 
-    void setSoilHumidity(int p_soil_humidity);
     int getMinimumPrimeSoilHumidity() const;
 
 private:
     LinearEquation m_drought_equation;
     LinearEquation m_flood_equation;
     SoilHumidityProperties m_properties;
-    int m_soil_humidity;
 };
 
 /***************
@@ -93,16 +85,13 @@ public:
 //    TemperatureConstrainer & operator=(const TemperatureConstrainer& other);
 
 
-    virtual int getStrength() const;
-    bool isTooCold() const;
-
-    void setTemperature(int p_temp);
+    virtual int getStrength(int p_temp) const;
+    bool isTooCold(int p_temp) const;
 
 private:
     LinearEquation m_chill_equation;
     LinearEquation m_warmth_equation;
     TemperatureProperties m_properties;
-    int m_temperature;
 };
 
 /*********
@@ -116,14 +105,11 @@ public:
 //    TemperatureConstrainer & operator=(const TemperatureConstrainer& other);
 
 
-    virtual int getStrength() const;
-
-    void setSlope(int p_slope);
+    virtual int getStrength(int p_slope) const;
 
 private:
     LinearEquation m_slope_equation;
     SlopeProperties m_properties;
-    int m_slope;
 };
 
 /***********
@@ -1,12 +1,16 @@
 #include "growth_manager.h"
 #include <math.h>
+#include <algorithm>
 #include <iostream>
 
+const int GrowthManager::_MIN_RANDOM_OFFSET = -5;
+const int GrowthManager::_MAX_RANDOM_OFFSET = 5;
+
 GrowthManager::GrowthManager(const GrowthProperties & p_growth_properties, const AgeingProperties & p_ageing_properties) :
     m_max_monthly_canopy_growth(p_growth_properties.max_canopy_width/ p_ageing_properties.start_of_decline),
     m_max_monthly_height_growth(p_growth_properties.max_height/ p_ageing_properties.start_of_decline),
     m_max_monthly_root_growth(p_growth_properties.max_root_size/p_ageing_properties.start_of_decline),
-    m_height(1.0f), m_root_size(1.0f), m_canopy_width(p_growth_properties.max_canopy_width > 0 ? 1.0f : 0.0f), m_dice_roller(-5,5)
+    m_initial_canopy_width(p_growth_properties.max_canopy_width > 0 ? 1.0f : 0.0f)
 {
 }
 
@@ -15,26 +19,26 @@ GrowthManager::~GrowthManager()
 
 }
 
-void GrowthManager::grow(int p_strength)
+float GrowthManager::getInitialHeight() const
 {
-    float growth_percentage(std::min(1.0f, std::max(.0f, (p_strength + m_dice_roller.generate())/100.0f))); // In rage  [0,1]
-
-    m_height += (growth_percentage * m_max_monthly_height_growth);
-    m_root_size += (growth_percentage * m_max_monthly_root_growth);
-    m_canopy_width += (growth_percentage * m_max_monthly_canopy_growth);
+    return 1.0f;
 }
 
-float GrowthManager::getHeight() const
+float GrowthManager::getInitialCanopyWidth() const
 {
-    return m_height;
+    return m_initial_canopy_width;
 }
 
-float GrowthManager::getCanopyWidth() const
+float GrowthManager::getInitialRootSize() const
 {
-    return m_canopy_width;
+    return 1.0f;
 }
 
-float GrowthManager::getRootSize() const
+void GrowthManager::grow(int p_strength, int p_random_offset, float & p_height, float & p_canopy_width, float & p_root_size) const
 {
-    return m_root_size;
+    float growth_percentage(std::min(1.0f, std::max(.0f, (p_strength + p_random_offset)/100.0f))); // In rage  [0,1]
+
+    p_height += (growth_percentage * m_max_monthly_height_growth);
+    p_root_size += (growth_percentage * m_max_monthly_root_growth);
+    p_canopy_width += (growth_percentage * m_max_monthly_canopy_growth);
 }
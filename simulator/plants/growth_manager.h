@@ -4,24 +4,27 @@
 #include <memory>
 
 #include "plantDB/plant_properties.h"
-#include "../../math/dice_roller.h"
 
+/**
+ * Holds the monthly growth rates of a specie. Shared by all plants of the specie, the
+ * sizes being stored per plant by the caller.
+ */
 class GrowthManager
 {
 public:
     GrowthManager(const GrowthProperties & p_growth_properties, const AgeingProperties & p_ageing_properties);
     ~GrowthManager();
 
-    float getHeight() const;
-    float getCanopyWidth() const;
-    float getRootSize() const;
-    void grow(int p_strength); // Must be called monthly!
+    float getInitialHeight() const;
+    float getInitialCanopyWidth() const;
+    float getInitialRootSize() const;
+    void grow(int p_strength, int p_random_offset, float & p_height, float & p_canopy_width, float & p_root_size) const; // Must be called monthly!
+
+    static const int _MIN_RANDOM_OFFSET;
+    static const int _MAX_RANDOM_OFFSET;
 
 private:
-    float m_height;
-    float m_root_size;
-    float m_canopy_width;
-    DiceRoller m_dice_roller;
+    float m_initial_canopy_width;
 
     float m_max_monthly_height_growth;
     float m_max_monthly_root_growth;
@@ -2,13 +2,21 @@
 #define PLANT_H
 
 #include <string>
+#include <vector>
+#ifndef HEADLESS_MODE
 #include <QColor>
+#endif
 #include <QPoint>
-#include <unordered_set>
-#include "plantDB/plant_properties.h"
-#include "growth_manager.h"
-#include "constrainers.h"
+#include <QString>
+#include "../../math/random_streams.h"
 
+class Specie;
+
+/**
+ * Value record of a single plant. Plants are stored column-wise in the PlantStorage, this
+ * record is only used to hand a plant over to the rest of the simulator. The specie data
+ * is referenced, never copied.
+ */
 class Plant {
 public:
     enum PlantStatus{
@@ -30,51 +38,37 @@ public:
         Temperature,
         Slope
     };
-    typedef std::map<ConstrainerType, float> Strengths;
-
 
-    Plant(SpecieProperties m_specie_properties, QColor p_color, QPoint p_center_coord, long p_unique_id, int p_random_id);
+    Plant(const Specie * p_specie, QPoint p_center_coord, int p_random_id);
     ~Plant();
 
-//    Plant & operator=(const Plant& other);
-
-    void newMonth();
-
     float getHeight() const;
     float getCanopyWidth() const;
     float getRootSize() const;
     int getMinimumSoilHumidityRequirement() const;
-    std::vector<QPoint> seed();
-    std::vector<QPoint> seed(int seed_count);
+    std::vector<QPoint> seed(RandomStream & random_stream);
+    std::vector<QPoint> seed(int seed_count, RandomStream & random_stream);
     int getVigor() const;
+#ifndef HEADLESS_MODE
     QColor getColor() const;
+#endif
+    const QString & getSpecieName() const;
 
-    PlantStatus getStatus();
-    void calculateStrength(int p_daily_illumination, int p_soil_humidity_percentage, int p_temp, int p_slope);
+    PlantStatus getStatus() const;
 
-    long m_unique_id;
+    int m_unique_id; // Assigned by the storage
     QPoint m_center_position;
-    QString m_specie_name;
     int m_specie_id;
-    const QColor m_color;
-
-private:
-    // Managers
-    GrowthManager m_growth_manager;
-
-    const SeedingProperties m_seeding_properties;
-
-    // Constrainers
-    ConstrainersWrapper m_constrainers;
+    const Specie * m_specie;
 
-    Strengths m_strengths;
-    ConstrainerType m_strength_bottleneck;
-
-    int m_strength;
-    int m_random_id; // Random number between 0 and 1000 used for statistical purposes
+    float m_height;
+    float m_canopy_width;
+    float m_root_size;
     int m_age;
-
+    int m_strength;
     int m_pain_enducer;
+    int m_random_id; // Random number between 0 and 1000 used for statistical purposes
+    PlantStatus m_status;
 };
 
 #endif //PLANT_H
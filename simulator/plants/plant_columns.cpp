@@ -0,0 +1,111 @@
+#include "plant_columns.h"
+#include "specie.h"
+
+PlantColumns::PlantColumns()
+{
+
+}
+
+PlantColumns::~PlantColumns()
+{
+
+}
+
+int PlantColumns::add(const Plant & p_plant)
+{
+    int id;
+    if(m_free_ids.size() > 0)
+    {
+        id = m_free_ids.back();
+        m_free_ids.pop_back();
+    }
+    else
+    {
+        id = m_id_to_slot.size();
+        m_id_to_slot.push_back(-1);
+    }
+
+    m_id_to_slot.write(id) = m_ids.size();
+
+    m_ids.push_back(id);
+    m_positions.push_back(p_plant.m_center_position);
+    m_heights.push_back(p_plant.m_height);
+    m_canopy_widths.push_back(p_plant.m_canopy_width);
+    m_root_sizes.push_back(p_plant.m_root_size);
+    m_ages.push_back(p_plant.m_age);
+    m_strengths.push_back(p_plant.m_strength);
+    m_pain_enducers.push_back(p_plant.m_pain_enducer);
+    m_random_ids.push_back(p_plant.m_random_id);
+    m_specie_indices.push_back(p_plant.m_specie->m_index);
+
+    return id;
+}
+
+void PlantColumns::remove(int p_id)
+{
+    int slot(m_id_to_slot[p_id]);
+    int last(m_ids.size()-1);
+
+    // Move the last plant into the freed slot
+    if(slot != last)
+    {
+        m_ids.write(slot) = m_ids[last];
+        m_positions.write(slot) = m_positions[last];
+        m_heights.write(slot) = m_heights[last];
+        m_canopy_widths.write(slot) = m_canopy_widths[last];
+        m_root_sizes.write(slot) = m_root_sizes[last];
+        m_ages.write(slot) = m_ages[last];
+        m_strengths.write(slot) = m_strengths[last];
+        m_pain_enducers.write(slot) = m_pain_enducers[last];
+        m_random_ids.write(slot) = m_random_ids[last];
+        m_specie_indices.write(slot) = m_specie_indices[last];
+
+        m_id_to_slot.write(m_ids[slot]) = slot;
+    }
+
+    m_ids.pop_back();
+    m_positions.pop_back();
+    m_heights.pop_back();
+    m_canopy_widths.pop_back();
+    m_root_sizes.pop_back();
+    m_ages.pop_back();
+    m_strengths.pop_back();
+    m_pain_enducers.pop_back();
+    m_random_ids.pop_back();
+    m_specie_indices.pop_back();
+
+    m_id_to_slot.write(p_id) = -1;
+    m_free_ids.push_back(p_id);
+}
+
+void PlantColumns::clear()
+{
+    m_ids.clear();
+    m_positions.clear();
+    m_heights.clear();
+    m_canopy_widths.clear();
+    m_root_sizes.clear();
+    m_ages.clear();
+    m_strengths.clear();
+    m_pain_enducers.clear();
+    m_random_ids.clear();
+    m_specie_indices.clear();
+
+    m_id_to_slot.clear();
+    m_free_ids.clear();
+}
+
+bool PlantColumns::contains(int p_id) const
+{
+    return p_id >= 0 && p_id < m_id_to_slot.size() && m_id_to_slot[p_id] != -1;
+}
+
+int PlantColumns::getSlot(int p_id) const
+{
+    return m_id_to_slot[p_id];
+}
+
+int PlantColumns::size() const
+{
+    return m_ids.size();
+}
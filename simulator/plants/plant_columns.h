@@ -0,0 +1,115 @@
+#ifndef PLANT_COLUMNS_H
+#define PLANT_COLUMNS_H
+
+#include <vector>
+#include <memory>
+#include <QPoint>
+
+#include "plant.h"
+
+/**
+ * Column split in fixed size chunks, which copies of the column share. Copying a column only copies the chunk
+ * pointers: a chunk is only copied when written while shared, or replaced without copy when about to be rewritten.
+ * Concurrent copies and writes must be serialized by the owner.
+ */
+template <class T> class ChunkedColumn {
+public:
+    static const int _CHUNK_SIZE = 4096;
+
+    ChunkedColumn() : m_size(0) {}
+
+    int size() const { return m_size; }
+    int getChunkCount() const { return m_chunks.size(); }
+
+    const T & operator[](int p_idx) const { return (*m_chunks[p_idx / _CHUNK_SIZE])[p_idx % _CHUNK_SIZE]; }
+    const T & back() const { return (*this)[m_size-1]; }
+    T & write(int p_idx) { return (*writable_chunk(p_idx / _CHUNK_SIZE))[p_idx % _CHUNK_SIZE]; }
+
+    /**
+     * Elements of the chunk, all to be overwritten. A shared chunk is replaced by a new one rather than copied:
+     * p_previous then keeps holding the elements as they were (the same chunk otherwise).
+     */
+    T * rewriteChunk(int p_chunk, std::shared_ptr<const std::vector<T> > & p_previous)
+    {
+        std::shared_ptr<std::vector<T> > & chunk(m_chunks[p_chunk]);
+        p_previous = chunk;
+        if(chunk.use_count() > 2)
+            chunk = std::make_shared<std::vector<T> >(chunk->size());
+        return chunk->data();
+    }
+
+    void push_back(const T & p_value)
+    {
+        if(m_size % _CHUNK_SIZE == 0)
+        {
+            m_chunks.push_back(std::make_shared<std::vector<T> >());
+            m_chunks.back()->reserve(_CHUNK_SIZE);
+        }
+        writable_chunk(m_size / _CHUNK_SIZE)->push_back(p_value);
+        m_size++;
+    }
+
+    void pop_back()
+    {
+        m_size--;
+        if(m_size % _CHUNK_SIZE == 0)
+            m_chunks.pop_back();
+        else
+            writable_chunk(m_size / _CHUNK_SIZE)->pop_back();
+    }
+
+    void clear()
+    {
+        m_chunks.clear(); // Shared chunks are left to the copies
+        m_size = 0;
+    }
+
+private:
+    std::vector<T> * writable_chunk(int p_chunk)
+    {
+        std::shared_ptr<std::vector<T> > & chunk(m_chunks[p_chunk]);
+        if(chunk.use_count() > 1)
+            chunk = std::make_shared<std::vector<T> >(*chunk);
+        return chunk.get();
+    }
+
+    std::vector<std::shared_ptr<std::vector<T> > > m_chunks;
+    int m_size;
+};
+
+/**
+ * Column-wise (structure of arrays) plant store. Every attribute lives in its own contiguous (per chunk)
+ * array, indexed by slot. Slots are kept dense through swap-remove deletion, the stable plant
+ * IDs being resolved to slots through an ID table. Freed IDs are recycled. Copies share their chunks
+ * until written, see ChunkedColumn.
+ */
+class PlantColumns {
+public:
+    PlantColumns();
+    ~PlantColumns();
+
+    int add(const Plant & p_plant); // Returns the plant id
+    void remove(int p_id);
+    void clear();
+
+    bool contains(int p_id) const;
+    int getSlot(int p_id) const;
+    int size() const;
+
+    ChunkedColumn<int> m_ids;
+    ChunkedColumn<QPoint> m_positions;
+    ChunkedColumn<float> m_heights;
+    ChunkedColumn<float> m_canopy_widths;
+    ChunkedColumn<float> m_root_sizes;
+    ChunkedColumn<int> m_ages;
+    ChunkedColumn<int> m_strengths;
+    ChunkedColumn<int> m_pain_enducers;
+    ChunkedColumn<int> m_random_ids;
+    ChunkedColumn<int> m_specie_indices;
+
+private:
+    ChunkedColumn<int> m_id_to_slot; // -1 if the id is free
+    ChunkedColumn<int> m_free_ids;
+};
+
+#endif // PLANT_COLUMNS_H
@@ -1,17 +1,18 @@
 #include "plant_factory.h"
 #include "plantDB/plant_db.h"
 
-#include <QColor>
 
-const std::vector<QColor> PlantFactory::_COLORS = PlantFactory::get_specie_colors();
-int PlantFactory::color_index = 0;
-std::map<int, int> PlantFactory::specie_id_to_color_index = std::map<int, int>();
-PlantFactory::PlantFactory(int area_width, int area_height) : m_dice_roller(0,1000), m_specie_properties(PlantDB().getAllPlantData()),
-    m_area_width(area_width), m_area_height(area_height)
+PlantFactory::PlantFactory(int area_width, int area_height) : PlantFactory(area_width, area_height, SpecieTable::load())
 {
-    for(auto it(m_specie_properties.begin()); it != m_specie_properties.end(); it++)
+
+}
+
+PlantFactory::PlantFactory(int area_width, int area_height, std::shared_ptr<const SpecieTable> p_specie_table) : m_specie_table(p_specie_table),
+    m_area_width(area_width), m_area_height(area_height), m_random_streams(), m_generated_plant_count(0)
+{
+    for(const Specie & specie : *m_specie_table)
     {
-        m_specie_name_to_id_mapper.emplace(it->second.specie_name, it->first);
+        m_specie_name_to_id_mapper.emplace(specie.m_specie_name, specie.m_specie_id);
     }
 }
 
@@ -20,7 +21,6 @@ PlantFactory::~PlantFactory()
 
 }
 
-static long unique_id = 1;
 Plant PlantFactory::generate(QString p_specie_name, QPoint p_center_coord)
 {
     return generate(get_specie_id(p_specie_name), p_center_coord);
@@ -33,15 +33,11 @@ Plant PlantFactory::generate(QString p_specie_name)
 
 Plant PlantFactory::generate(int p_specie_id, QPoint p_center_coord)
 {
-    if(specie_id_to_color_index.find(p_specie_id) == specie_id_to_color_index.end())
-        specie_id_to_color_index.emplace(p_specie_id, color_index++);
+    RandomStream random_stream(m_random_streams.stream(RandomStreams::PlantRandomId, m_generated_plant_count++));
 
-    QColor color(_COLORS.at(specie_id_to_color_index[p_specie_id]));
-    return Plant(m_specie_properties.find(p_specie_id)->second,
-                 color,
+    return Plant(&m_specie_table->getBySpecieId(p_specie_id),
                  p_center_coord,
-                 unique_id++,
-                 m_dice_roller.generate());
+                 random_stream.uniformInt(0, 1000));
 }
 
 Plant PlantFactory::generate(int p_specie_id)
@@ -53,8 +49,8 @@ std::vector<QString> PlantFactory::getAllSpecieNames()
 {
     std::vector<QString> ret;
 
-    for(auto it (m_specie_properties.begin()); it != m_specie_properties.end(); it++)
-        ret.push_back(it->second.specie_name);
+    for(const Specie & specie : *m_specie_table)
+        ret.push_back(specie.m_specie_name);
 
     return ret;
 }
@@ -66,30 +62,23 @@ int PlantFactory::get_specie_id(const QString & name)
 
 QPoint PlantFactory::generate_random_position()
 {
-    return QPoint(rand()%(m_area_width-1), rand()%(m_area_height-1));
+    RandomStream random_stream(m_random_streams.stream(RandomStreams::PlantPlacement, m_generated_plant_count));
+
+    return QPoint(random_stream.uniformInt(0, m_area_width-2), random_stream.uniformInt(0, m_area_height-2));
 }
 
 const SpecieProperties & PlantFactory::getSpecieProperties(int p_specie_id)
 {
-    return m_specie_properties.find(p_specie_id)->second;
+    return m_specie_table->getBySpecieId(p_specie_id).m_properties;
 }
 
-std::vector<QColor> PlantFactory::get_specie_colors()
+std::shared_ptr<const SpecieTable> PlantFactory::getSpecieTable() const
 {
-    std::vector<QColor> ret;
-    ret.push_back(Qt::white);
-    ret.push_back(Qt::red);
-    ret.push_back(Qt::green);
-    ret.push_back(Qt::blue);
-    ret.push_back(Qt::cyan);
-    ret.push_back(Qt::magenta);
-    ret.push_back(Qt::yellow);
-    ret.push_back(Qt::darkRed);
-    ret.push_back(Qt::darkGreen);
-    ret.push_back(Qt::darkBlue);
-    ret.push_back(Qt::darkCyan);
-    ret.push_back(Qt::darkMagenta);
-    ret.push_back(Qt::darkYellow);
+    return m_specie_table;
+}
 
-    return ret;
+void PlantFactory::setRandomStreams(const RandomStreams & p_random_streams)
+{
+    m_random_streams = p_random_streams;
+    m_generated_plant_count = 0;
 }
@@ -3,18 +3,19 @@
 
 #include <map>
 #include <string>
-#include <QColor>
 #include <memory>
 #include <stack>
 
-#include "../../math/dice_roller.h"
+#include "../../math/random_streams.h"
 #include "plantDB/plant_db.h"
 #include "plant.h"
+#include "specie.h"
 #include <QPoint>
 
 class PlantFactory {
 public:
     PlantFactory(int area_width, int area_height);
+    PlantFactory(int area_width, int area_height, std::shared_ptr<const SpecieTable> p_specie_table); // Specie table shared with other factories
     ~PlantFactory();
     Plant generate(QString p_specie_name, QPoint p_center_coord);
     Plant generate(QString p_specie_name);
@@ -22,20 +23,18 @@ public:
     Plant generate(int p_specie_id);
     std::vector<QString> getAllSpecieNames();
     const SpecieProperties & getSpecieProperties(int p_specie_id);
+    std::shared_ptr<const SpecieTable> getSpecieTable() const;
+    void setRandomStreams(const RandomStreams & p_random_streams); // Restarts the generated plant sequence
 
 private:
     int get_specie_id(const QString & name);
     QPoint generate_random_position();
 
     int m_area_width, m_area_height;
-    PlantDB::SpeciePropertiesHolder m_specie_properties;
+    std::shared_ptr<const SpecieTable> m_specie_table;
     std::map<QString, int> m_specie_name_to_id_mapper;
-    DiceRoller m_dice_roller;
-
-    static std::map<int, int> specie_id_to_color_index;
-    static std::vector<QColor> get_specie_colors();
-    static int color_index;
-    const static std::vector<QColor> _COLORS;
+    RandomStreams m_random_streams;
+    long m_generated_plant_count; // Keys the random streams of each generated plant
 };
 
 #endif // PLANT_FACTORY_H
@@ -1,19 +1,15 @@
 #include "plants_storage.h"
 #include "../../utils/callback_listener.h"
-
-#include <ecotracker/tracker.h>
-#include <radialDistribution/analysis_point.h>
-#include <radialDistribution/analyser/analyzer.h>
+#include "../../utils/trace_recorder.h"
+#include "../../utils/tracker_writer.h"
 
 #include <iostream>
 #include <algorithm>
-#include <QImage>
-#include <QPainter>
-#include <QTemporaryDir>
 
 #include <QDebug>
 
 #define LOCATION_STORAGE_CELL_SIZE 100
+#define UPDATE_SLICES_PER_THREAD 4 // More slices than threads to balance the load
 
 //namespace std {
 //  template <>
@@ -34,13 +30,16 @@ bool operator<(const QPoint & lhs, const QPoint & rhs)
     return lhs.x() < rhs.x() || lhs.y() < rhs.y();
 }
 
-PlantStorage::PlantStorage(int area_width, int area_height) : m_plants(), m_plant_count(0),
+PlantStorage::PlantStorage(int area_width, int area_height, std::shared_ptr<const SpecieTable> p_specie_table) :
+  m_specie_table(p_specie_table), m_plants(), m_specie_id_plant_counts(),
   m_location_queryable_plants(LOCATION_STORAGE_CELL_SIZE, LOCATION_STORAGE_CELL_SIZE, std::ceil(((float)area_width)/LOCATION_STORAGE_CELL_SIZE),
                             std::ceil(((float)area_height)/LOCATION_STORAGE_CELL_SIZE)),
-  m_statistical_analyzer_config(0, 200, 20, area_width, area_width),
-  m_area_width(area_width), m_area_height(area_height)
+  m_seeding_index(LOCATION_STORAGE_CELL_SIZE),
+  m_storage_accessor_mutex("plant_storage_lock_wait"),
+  m_area_width(area_width), m_area_height(area_height),
+  m_radial_distribution_analyzer(0, 200, 20, area_width, area_height)
 {
-
+    setThreadCount(0);
 }
 
 PlantStorage::~PlantStorage()
@@ -51,43 +50,127 @@ PlantStorage::~PlantStorage()
 // NOT THREAD SAFE!!
 Plant PlantStorage::operator[](int plant_id) const
 {
-    auto it(m_plants.find(plant_id));
-
-
-    if(it != m_plants.end())
+    if(m_plants.contains(plant_id))
     {
-        return it->second;
+        return get_plant(m_plants.getSlot(plant_id));
     }
 
     throw PlantStorage::InvalidPlantIDException();
 }
 
-void PlantStorage::update(EnvironmentManager & environment_manager, std::vector<Plant> & surviving_plants, std::vector<Plant> & deceased_plants, bool mutex_lock)
+// NOT THREAD SAFE!!
+Plant PlantStorage::get_plant(int slot) const
+{
+    Plant p(&(*m_specie_table)[m_plants.m_specie_indices[slot]], m_plants.m_positions[slot], m_plants.m_random_ids[slot]);
+    p.m_unique_id = m_plants.m_ids[slot];
+    p.m_height = m_plants.m_heights[slot];
+    p.m_canopy_width = m_plants.m_canopy_widths[slot];
+    p.m_root_size = m_plants.m_root_sizes[slot];
+    p.m_age = m_plants.m_ages[slot];
+    p.m_strength = m_plants.m_strengths[slot];
+    p.m_pain_enducer = m_plants.m_pain_enducers[slot];
+
+    return p;
+}
+
+void PlantStorage::setThreadCount(int p_thread_count)
+{
+    if(p_thread_count <= 0)
+        p_thread_count = ThreadPool::defaultThreadCount();
+
+    if(m_thread_pool && m_thread_pool->getThreadCount() == p_thread_count)
+        return;
+
+    m_thread_pool.reset(new ThreadPool(p_thread_count));
+    lock();
+    m_analysis_thread_pool.reset(); // Created on the next statistical snapshot, snapshots in progress keeping theirs
+    unlock();
+}
+
+/**
+ * Two phases:
+ *  1. Evaluation (parallel): each thread samples the environment for a slice of plants and calculates
+ *     their strength, status and growth. Only reads the plants and the environment.
+ *  2. Commit (serial): applies the evaluated updates and removes the deceased plants.
+ * Random draws are keyed by plant id and month so the outcome does not depend on the thread count.
+ */
+bool PlantStorage::update(EnvironmentManager & environment_manager, const RandomStreams & p_random_streams, int p_elapsed_months,
+                          std::vector<Plant> & surviving_plants, std::vector<Plant> & deceased_plants, bool mutex_lock,
+                          const std::atomic<bool> * p_cancel)
 {
     if(mutex_lock)
         lock();
-    for(auto it(m_plants.begin()); it!= m_plants.end(); it++)
-    {
-        Plant & p(it->second);
 
-//        qCritical() << "Updating for plant: " << p.m_specie_name << "(ID: " << p.m_specie_id;
-        int illum(environment_manager.getDailyIllumination(p.m_center_position, p.m_unique_id, p.getCanopyWidth(), p.getHeight()));
-        int sh(environment_manager.getSoilHumidity(p.m_center_position, p.getRootSize(), p.m_unique_id));
-        int temp(environment_manager.getTemperature());
-        int slope(environment_manager.getSlope());
+    int plant_count(m_plants.size());
 
-        p.calculateStrength(illum, sh, temp, slope);
+    // Ensures environment reads are free of side effects
+    environment_manager.refresh();
 
-        if(p.getStatus() == Plant::PlantStatus::Alive)
-        {
-//            qCritical() << "Roots radius before: " << p.getRootSize();
-            p.newMonth();
-//            qCritical() << "Roots radius after " << p.getRootSize() << " [ S: " << p.getVigor();
-            surviving_plants.push_back(p);
-        }
-        else // Dead
+    /**************
+     * EVALUATION *
+     **************/
+    m_plant_updates.resize(plant_count);
+    int slice_count(std::min(plant_count, m_thread_pool->getThreadCount() * UPDATE_SLICES_PER_THREAD));
+    if(slice_count > 0)
+    {
+        int slice_size(std::ceil(((float)plant_count)/slice_count));
+        m_thread_pool->run(slice_count, [this, &environment_manager, &p_random_streams, p_elapsed_months, slice_size, plant_count, p_cancel](int p_slice, int p_thread_idx) {
+            if(p_cancel && p_cancel->load(std::memory_order_relaxed))
+                return;
+            TraceRecorder::Scope trace("evaluate_plants");
+            evaluate_plants(environment_manager, p_random_streams, p_elapsed_months, p_slice * slice_size, std::min(plant_count, (p_slice+1) * slice_size));
+        });
+    }
+
+    // Nothing has been written yet: the month can be dropped
+    if(p_cancel && p_cancel->load())
+    {
+        if(mutex_lock)
+            unlock();
+        return false;
+    }
+
+    /**********
+     * COMMIT *
+     **********/
+    // Chunk by chunk: chunks still shared with a snapshot are rewritten into new ones rather than copied first
+    PlantColumns & plants(m_plants);
+    surviving_plants.reserve(plant_count);
+    for(int chunk(0); chunk < plants.m_ids.getChunkCount(); chunk++)
+    {
+        std::shared_ptr<const std::vector<int> > previous_ages, previous_strengths, previous_pain_enducers;
+        std::shared_ptr<const std::vector<float> > previous_heights, previous_canopy_widths, previous_root_sizes;
+        int * ages(plants.m_ages.rewriteChunk(chunk, previous_ages));
+        int * strengths(plants.m_strengths.rewriteChunk(chunk, previous_strengths));
+        int * pain_enducers(plants.m_pain_enducers.rewriteChunk(chunk, previous_pain_enducers));
+        float * heights(plants.m_heights.rewriteChunk(chunk, previous_heights));
+        float * canopy_widths(plants.m_canopy_widths.rewriteChunk(chunk, previous_canopy_widths));
+        float * root_sizes(plants.m_root_sizes.rewriteChunk(chunk, previous_root_sizes));
+
+        int first_slot(chunk * ChunkedColumn<int>::_CHUNK_SIZE);
+        for(int slot(first_slot), i(0); slot < std::min(plant_count, first_slot + ChunkedColumn<int>::_CHUNK_SIZE); slot++, i++)
         {
-            deceased_plants.push_back(p);
+            const PlantUpdate & plant_update(m_plant_updates[slot]);
+            strengths[i] = plant_update.strength;
+            pain_enducers[i] = plant_update.pain_enducer;
+
+            if(plant_update.status == Plant::PlantStatus::Alive)
+            {
+                ages[i] = (*previous_ages)[i] + 1;
+                heights[i] = plant_update.height;
+                canopy_widths[i] = plant_update.canopy_width;
+                root_sizes[i] = plant_update.root_size;
+                surviving_plants.push_back(get_plant(slot));
+            }
+            else // Dead
+            {
+                ages[i] = (*previous_ages)[i];
+                heights[i] = (*previous_heights)[i];
+                canopy_widths[i] = (*previous_canopy_widths)[i];
+                root_sizes[i] = (*previous_root_sizes)[i];
+                deceased_plants.push_back(get_plant(slot));
+                deceased_plants.back().m_status = plant_update.status;
+            }
         }
     }
     for(Plant & p : deceased_plants)
@@ -95,26 +178,62 @@ void PlantStorage::update(EnvironmentManager & environment_manager, std::vector<
 
     if(mutex_lock)
         unlock();
+
+    return true;
+}
+
+// Must only read shared state: called concurrently
+void PlantStorage::evaluate_plants(EnvironmentManager & environment_manager, const RandomStreams & p_random_streams, int p_elapsed_months,
+                                   int p_from_slot, int p_to_slot)
+{
+    int temp(environment_manager.getTemperature());
+    int slope(environment_manager.getSlope());
+
+    for(int slot(p_from_slot); slot < p_to_slot; slot++)
+    {
+        const Specie & specie((*m_specie_table)[m_plants.m_specie_indices[slot]]);
+        int id(m_plants.m_ids[slot]);
+        const QPoint & position(m_plants.m_positions[slot]);
+        PlantUpdate & plant_update(m_plant_updates[slot]);
+
+        int illum(environment_manager.getDailyIllumination(position, id, m_plants.m_canopy_widths[slot], m_plants.m_heights[slot]));
+        int sh(environment_manager.getSoilHumidity(position, m_plants.m_root_sizes[slot], id));
+
+        Plant::ConstrainerType bottleneck;
+        int min_strength(specie.calculateStrength(m_plants.m_ages[slot], illum, sh, temp, slope, bottleneck));
+
+        // Pain enducer is used to prevent a plant from being in negative strength too long
+        plant_update.pain_enducer = (min_strength < 0 ? m_plants.m_pain_enducers[slot] + 10 : 0);
+        plant_update.strength = min_strength - plant_update.pain_enducer;
+        plant_update.status = specie.getStatus(plant_update.strength, m_plants.m_random_ids[slot], bottleneck, illum, sh, temp);
+
+        plant_update.height = m_plants.m_heights[slot];
+        plant_update.canopy_width = m_plants.m_canopy_widths[slot];
+        plant_update.root_size = m_plants.m_root_sizes[slot];
+        if(plant_update.status == Plant::PlantStatus::Alive && plant_update.strength > 0) // Only grow if resource balance is positif
+        {
+            RandomStream random_stream(p_random_streams.stream(RandomStreams::Growth, id, p_elapsed_months));
+            specie.m_growth_manager.grow(plant_update.strength,
+                                         random_stream.uniformInt(GrowthManager::_MIN_RANDOM_OFFSET, GrowthManager::_MAX_RANDOM_OFFSET),
+                                         plant_update.height, plant_update.canopy_width, plant_update.root_size);
+        }
+    }
 }
 
-void PlantStorage::add(const Plant & p_plant, bool mutex_lock )
+void PlantStorage::add(Plant & p_plant, bool mutex_lock )
 {
     if(mutex_lock)
         lock();
-//    qCritical() << "*******************************************";
-//    qCritical() << "ADDING PLANT [" << p_plant.m_center_position.x() << "," <<
-//                                  p_plant.m_center_position.y() << "] --> " << p_plant.m_unique_id;
     // Raw plant storage
-    m_plants.emplace(p_plant.m_unique_id, p_plant);
+    p_plant.m_unique_id = m_plants.add(p_plant);
 
     // By Specie ID
-    m_specie_id_queryable_plants[p_plant.m_specie_id].insert(p_plant.m_unique_id);
+    m_specie_id_plant_counts[p_plant.m_specie_id]++;
 
     // By Location
     LocationCell & cell(m_location_queryable_plants.getCell(p_plant.m_center_position, PlantSpatialHashMap::Space::_WORLD));
     cell.species[p_plant.m_specie_id].emplace(p_plant.m_center_position, p_plant.m_unique_id);
-
-    m_plant_count++;
+    m_seeding_index.add(p_plant.m_unique_id, p_plant.m_specie_id, p_plant.m_center_position);
 
     if(mutex_lock)
         unlock();
@@ -127,35 +246,39 @@ void PlantStorage::remove(const Plant & p_plant, bool mutex_lock)
         if(mutex_lock)
             lock();
 
-//        qCritical() << "*******************************************";
-//        qCritical() << "REMOVING PLANT [" << p_plant.m_center_position.x() << "," <<
-//                                      p_plant.m_center_position.y() << "] --> " << p_plant.m_unique_id;
-
         // Raw plant storage
-//        qCritical() << "PLANTS CONTAINS --> " << (m_plants.find(p_plant.m_unique_id) == m_plants.end() ? "NO!" : "YES!" );
-        m_plants.erase(p_plant.m_unique_id);
+        m_plants.remove(p_plant.m_unique_id);
+
         // By Specie ID
-//        qCritical() << "PLANTS BY SPECIE CONTAINS --> " <<
-//                       ( m_specie_id_queryable_plants[p_plant.m_specie_id].find(p_plant.m_unique_id) ==  m_specie_id_queryable_plants[p_plant.m_specie_id].end() ? "NO!" : "YES!" );
-        m_specie_id_queryable_plants[p_plant.m_specie_id].erase(p_plant.m_unique_id);
+        m_specie_id_plant_counts[p_plant.m_specie_id]--;
 
         // By Location
         LocationCell & cell(m_location_queryable_plants.getCell(p_plant.m_center_position, PlantSpatialHashMap::Space::_WORLD));
-//        qCritical() << "PLANTS BY LOCATION CONTAINS ? " << ( cell.species[p_plant.m_specie_id].find(p_plant.m_center_position) == cell.species[p_plant.m_specie_id].end() ? "NO" : "YES" );
         cell.species[p_plant.m_specie_id].erase(p_plant.m_center_position);
+        m_seeding_index.remove(p_plant.m_unique_id);
 
         if(mutex_lock)
             unlock();
-
-        m_plant_count--;
     }
 }
 
+// Only copies the chunk pointers
+std::shared_ptr<const PlantColumns> PlantStorage::getColumnsSnapshot(bool mutex_lock) const
+{
+    if(mutex_lock)
+        lock();
+    std::shared_ptr<const PlantColumns> snapshot(std::make_shared<const PlantColumns>(m_plants));
+    if(mutex_lock)
+        unlock();
+
+    return snapshot;
+}
+
 bool PlantStorage::contains_plant(int plant_id, bool mutex_lock) const
 {
     if(mutex_lock)
         lock();
-    bool found(m_plants.find(plant_id) != m_plants.end());
+    bool found(m_plants.contains(plant_id));
     if(mutex_lock)
         unlock();
 
@@ -164,43 +287,43 @@ bool PlantStorage::contains_plant(int plant_id, bool mutex_lock) const
 
 bool PlantStorage::containsSpecie(int specie_id, bool mutex_lock) const
 {
-    auto it(m_specie_id_queryable_plants.find(specie_id));
-    bool found ( it != m_specie_id_queryable_plants.end() && it->second.size() > 0);
+    auto it(m_specie_id_plant_counts.find(specie_id));
+    bool found ( it != m_specie_id_plant_counts.end() && it->second > 0);
 
     return found;
 }
 
-std::vector<Plant> PlantStorage::getOnePlantPerCell(int p_specie_id, bool mutex_lock) const
+// O(number of cells holding the specie): served by the seeding index
+std::vector<Plant> PlantStorage::getOnePlantPerCell(int p_specie_id, RandomStream & p_random_stream, bool mutex_lock) const
 {
     std::vector<Plant> ret;
 
-    if(containsSpecie(p_specie_id, mutex_lock))
-    {
-        std::vector<std::unordered_map<QPoint, int> > relevant_cells;
-
-        if(mutex_lock)
-            lock();
-        for(auto location_cell(m_location_queryable_plants.cbegin()); location_cell != m_location_queryable_plants.cend(); location_cell++)
-        {
-            auto plants(location_cell->second.species.find(p_specie_id));
-            if(plants != location_cell->second.species.end() && plants->second.size() > 0 )
-            {
-                relevant_cells.push_back(plants->second);
-            }
-        }
+    if(mutex_lock)
+        lock();
+    std::vector<int> plant_ids(m_seeding_index.drawOnePerCell(p_specie_id, p_random_stream));
+    ret.reserve(plant_ids.size());
+    for(int plant_id : plant_ids)
+        ret.push_back(get_plant(m_plants.getSlot(plant_id)));
+    if(mutex_lock)
+        unlock();
 
-        std::sort(relevant_cells.begin(), relevant_cells.end(), [](std::unordered_map<QPoint, int> lhs, std::unordered_map<QPoint, int> rhs) {return lhs.size() < rhs.size();});
+    return ret;
+}
 
-        for(std::unordered_map<QPoint, int> & plant_cell : relevant_cells)
-        {
-            auto random_position(plant_cell.begin());
-            std::advance(random_position, rand() % plant_cell.size());
-            ret.push_back(this->operator [](random_position->second));
-        }
+std::vector<Plant> PlantStorage::getRandomPlants(int p_count, RandomStream & p_random_stream, bool mutex_lock) const
+{
+    std::vector<Plant> ret;
 
-        if(mutex_lock)
-            unlock();
+    if(mutex_lock)
+        lock();
+    if(m_plants.size() > 0)
+    {
+        ret.reserve(p_count);
+        for(int i(0); i < p_count; i++)
+            ret.push_back(get_plant(p_random_stream.uniformInt(0, m_plants.size()-1)));
     }
+    if(mutex_lock)
+        unlock();
 
     return ret;
 }
@@ -211,30 +334,50 @@ std::vector<Plant> PlantStorage::getPlants(bool mutex_lock) const
 
     if(mutex_lock)
         lock();
-    for(auto it(m_plants.begin()); it != m_plants.end(); it++)
-        all_plants.push_back(it->second);
+    all_plants.reserve(m_plants.size());
+    for(int slot(0); slot < m_plants.size(); slot++)
+        all_plants.push_back(get_plant(slot));
     if(mutex_lock)
         unlock();
 
     return all_plants;
 }
 
-std::list<Plant> PlantStorage::getSortedPlants(SortingCriteria p_sorting_criteria, bool mutex_lock) const
+std::vector<Plant> PlantStorage::getSortedPlants(SortingCriteria p_sorting_criteria, bool mutex_lock) const
 {
-    std::vector<Plant> plants(getPlants(mutex_lock));
+    std::vector<Plant> ret;
+
+    if(mutex_lock)
+        lock();
 
-    std::list<Plant> ret;
-    ret.insert(ret.begin(), plants.begin(), plants.end());
+    // Sort the slots on the relevant column only, then gather
+    std::vector<int> slots(m_plants.size());
+    for(int slot(0); slot < slots.size(); slot++)
+        slots[slot] = slot;
 
     switch(p_sorting_criteria)
     {
     case SortingCriteria::Strength:
-        ret.sort([](const Plant & lhs, const Plant & rhs){ return lhs.getVigor() > rhs.getVigor(); });
+    {
+        const ChunkedColumn<int> & strengths(m_plants.m_strengths);
+        std::sort(slots.begin(), slots.end(), [&strengths](int lhs, int rhs){ return strengths[lhs] > strengths[rhs]; });
         break;
+    }
     case SortingCriteria::Height:
-        ret.sort([](const Plant & lhs, const Plant & rhs){ return lhs.getHeight() > rhs.getHeight(); });
+    {
+        const ChunkedColumn<float> & heights(m_plants.m_heights);
+        std::sort(slots.begin(), slots.end(), [&heights](int lhs, int rhs){ return heights[lhs] > heights[rhs]; });
         break;
     }
+    }
+
+    ret.reserve(slots.size());
+    for(int slot : slots)
+        ret.push_back(get_plant(slot));
+
+    if(mutex_lock)
+        unlock();
+
     return ret;
 }
 
@@ -243,20 +386,16 @@ void PlantStorage::clear(bool mutex_lock)
     if(mutex_lock)
         lock();
     m_plants.clear();
-    m_specie_id_queryable_plants.clear();
+    m_specie_id_plant_counts.clear();
     m_location_queryable_plants.clear();
+    m_seeding_index.clear();
     if(mutex_lock)
         unlock();
 }
 
-PlantStorage::SpecieQueryablePlants PlantStorage::getPlantsBySpecies()
-{
-    return m_specie_id_queryable_plants;
-}
-
 int PlantStorage::getPlantCount() const
 {
-    return m_plant_count;
+    return m_plants.size();
 }
 
 bool PlantStorage::isPlantAtLocation(QPoint p_location, bool mutex_lock) const
@@ -292,146 +431,99 @@ std::set<int> PlantStorage::getSpecieIds(bool mutex_lock) const
     std::set<int> specie_ids;
     if(mutex_lock)
         lock();
-    for(auto it(m_specie_id_queryable_plants.begin()); it != m_specie_id_queryable_plants.end(); it++)
-        specie_ids.insert(it->first);\
+    for(auto it(m_specie_id_plant_counts.begin()); it != m_specie_id_plant_counts.end(); it++)
+        specie_ids.insert(it->first);
 
     if(mutex_lock)
         unlock();
     return specie_ids;
 }
 
-#define SNAPSHOTS_FOLDER "/home/harry/snapshots/snapshot_"
-#define BASE_PAINTER_IDX -1
-void PlantStorage::generateSnapshot(bool mutex_lock) const
+std::map<int, int> PlantStorage::getSpeciePlantCounts(bool mutex_lock) const
 {
-    std::set<int> specie_ids(getSpecieIds());
-    std::map<int, QImage *> specie_id_to_image;
-    std::map<int, QPainter *> specie_id_to_painter;
-
-    // ADD THE BASE PAINTER
-    QImage * base_img(new QImage(m_area_width, m_area_height, QImage::Format_RGB32));
-    base_img->fill(Qt::GlobalColor::black);
-    QPainter * base_painter(new QPainter(base_img));
-    for(int specie_id : specie_ids)// -1 is the base painter (all species)
-    {
-        QImage * img(new QImage(m_area_width, m_area_height, QImage::Format_RGB32));
-        img->fill(Qt::GlobalColor::black);
-        QPainter * painter(new QPainter(img));
-        specie_id_to_image.emplace(specie_id, img);
-        specie_id_to_painter.emplace(specie_id, painter);
-    }
-
     if(mutex_lock)
         lock();
-    for(auto specie(m_specie_id_queryable_plants.begin()); specie != m_specie_id_queryable_plants.end(); specie++)
-    {
-        QPainter * specie_painter = specie_id_to_painter[specie->first];
-        for(auto plant_id(specie->second.begin()); plant_id != specie->second.end(); plant_id++)
-        {
-            Plant p (this->operator [](*plant_id));
+    std::map<int, int> counts(m_specie_id_plant_counts);
+    if(mutex_lock)
+        unlock();
+    return counts;
+}
 
-            specie_painter->setBrush(p.m_color);
-            base_painter->setBrush(p.m_color);
+#ifndef HEADLESS_MODE
+void PlantStorage::generateSnapshot(SnapshotSettings p_settings, bool mutex_lock) const
+{
+    TraceRecorder::setThreadName("snapshot");
+    TraceRecorder::Scope trace("snapshot");
+
+    std::shared_ptr<const PlantColumns> plants(getColumnsSnapshot(mutex_lock));
+    std::vector<SnapshotDisc> discs;
+    discs.reserve(plants->size());
+    for(int slot(0); slot < plants->size(); slot++)
+        discs.push_back(SnapshotDisc{plants->m_positions[slot], plants->m_canopy_widths[slot]/2.0f, plants->m_specie_indices[slot]});
+    plants.reset(); // Leaves the chunks to the simulation
+
+    SnapshotRasterizer rasterizer(m_area_width, m_area_height, p_settings);
+    if(rasterizer.write(discs, *m_specie_table))
+        std::cout << "Snapshot created in " << p_settings.directory.toStdString() << std::endl;
+    else
+        std::cerr << "Unable to write the snapshot to " << p_settings.directory.toStdString() << std::endl;
+}
+#endif
 
-            int radius(std::max(1,(int)std::round(p.getCanopyWidth()/2.0f)));
-            specie_painter->drawEllipse(p.m_center_position,radius,radius);
-            base_painter->drawEllipse(p.m_center_position,radius,radius);
-        }
-        specie_painter->end();
-    }
-    base_painter->end();
+void PlantStorage::generateStatisticalSnapshot(float slope, std::vector<int> humidities, std::vector<int> illuminations, std::vector<int> temperatures, int elapsed_months,
+                                               int p_sample_budget, CallbackListener * work_completion_listener, bool mutex_lock)
+{
+    TraceRecorder::setThreadName("statistical_snapshot");
+    TraceRecorder::Scope trace("statistical_snapshot");
 
+    std::map<float,int> avg_height_to_specie_id;
+    // Create analysis points
+    RadialDistributionAnalyzer::Categories specie_analysis_points;
+    std::map<int, float> specie_total_height;
+    if(mutex_lock)
+        lock();
+    std::shared_ptr<const PlantColumns> plants(getColumnsSnapshot(false));
+    std::set<int> specie_ids(getSpecieIds(false));
+    if(!m_analysis_thread_pool)
+        m_analysis_thread_pool = std::make_shared<ThreadPool>(m_thread_pool->getThreadCount());
+    std::shared_ptr<ThreadPool> thread_pool(m_analysis_thread_pool); // Kept alive should the thread count change meanwhile
     if(mutex_lock)
         unlock();
 
-    // BASE
-    QString filename(SNAPSHOTS_FOLDER);
-    filename.append("all");
-    filename.append(".png");
-    base_img->save(filename);
-
-    for(int specie_id : specie_ids) // -1 is the base painter (all species)
+    // The simulation carries on while the snapshot is read
+    for(int slot(0); slot < plants->size(); slot++)
     {
-        QImage * img(specie_id_to_image[specie_id]);
-        QString filename(SNAPSHOTS_FOLDER);
-        filename.append(specie_id == BASE_PAINTER_IDX ? "all" : QString::number(specie_id));
-        filename.append(".png");
-        img->save(filename);
+        int specie_id((*m_specie_table)[plants->m_specie_indices[slot]].m_specie_id);
+        float height(plants->m_heights[slot]);
+        specie_total_height[specie_id] += height;
+        specie_analysis_points[specie_id].push_back(RadialDistributionAnalyzer::Point{plants->m_positions[slot],
+                                                                                     std::max(1.0f,plants->m_canopy_widths[slot]/2.0f)});
     }
-
-    // DELETIONS
-    for(auto it(specie_id_to_painter.begin()); it != specie_id_to_painter.end(); it++)
+    plants.reset(); // Leaves the chunks to the simulation
+    for(auto specie(specie_analysis_points.begin()); specie != specie_analysis_points.end(); specie++)
     {
-        specie_id_to_painter.erase(it);
-        delete it->second;
+        float avg_height(specie_total_height[specie->first] / specie->second.size());
+        while(avg_height_to_specie_id.find(avg_height) != avg_height_to_specie_id.end())
+            avg_height++;
+        avg_height_to_specie_id.emplace(avg_height, specie->first);
     }
-    for(auto it(specie_id_to_image.begin()); it != specie_id_to_image.end(); it++)
+    /**********************
+     * PREPARE CATEGORIES *
+     **********************/
+    if(specie_analysis_points.size() > 0)
     {
-        specie_id_to_image.erase(it);
-        delete it->second;
+        std::vector<int> priority_sorted_category_ids;
+        for(auto it(avg_height_to_specie_id.rbegin()); it != avg_height_to_specie_id.rend(); it++)
+            priority_sorted_category_ids.push_back(it->second);
+
+        // Results stay in memory: written to the database asynchronously, the listener being called once done
+        std::vector<RadialDistribution> distributions(m_radial_distribution_analyzer.analyze(specie_analysis_points, priority_sorted_category_ids,
+                                                                                              *thread_pool, p_sample_budget));
+        TrackerWriter::instance().submit(TrackerWriter::Entry{TrackerWriter::timestamp(), (int) std::round(slope), humidities, illuminations, temperatures,
+                                                              elapsed_months, specie_ids, std::move(distributions), work_completion_listener});
+        return;
     }
 
-    delete base_img;
-    delete base_painter;
-    std::cout << "Snapshot created!" << std::endl;
-}
-
-void PlantStorage::generateStatisticalSnapshot(float slope, std::vector<int> humidities, std::vector<int> illuminations, std::vector<int> temperatures, int elapsed_months,
-                                               CallbackListener * work_completion_listener, bool mutex_lock)
-{
-    QTemporaryDir tmp_dir;
-    if(tmp_dir.isValid())
-    {
-        std::map<float,int> avg_height_to_specie_id;
-        // Create analysis points
-        std::map<int, std::vector<AnalysisPoint>> specie_analysis_points;
-        if(mutex_lock)
-            lock();
-        for(auto specie(m_specie_id_queryable_plants.begin()); specie != m_specie_id_queryable_plants.end(); specie++)
-        {
-            if(specie->second.size() > 0)
-            {
-                int specie_id(specie->first);
-    //            qCritical() << "Processing specie id: " << specie_id;
-                float avg_height = 0;
-                std::vector<AnalysisPoint> analysis_points;
-                for(auto plant(specie->second.begin()); plant != specie->second.end(); plant++)
-                {
-                    Plant p ( this->operator []( *plant) );
-    //                qCritical() << "Processing plant id: " << p.m_unique_id;
-                    avg_height += p.getHeight();
-                    analysis_points.push_back(AnalysisPoint(specie_id, p.m_center_position, std::max(1.0f,p.getCanopyWidth()/2.0f), p.getRootSize(), p.getHeight()));
-                }
-
-                if(analysis_points.size() > 0)
-                    avg_height /= specie->second.size();
-                while(avg_height_to_specie_id.find(avg_height) != avg_height_to_specie_id.end())
-                    avg_height++;
-                avg_height_to_specie_id.emplace(avg_height, specie_id);
-                specie_analysis_points.emplace(specie_id, analysis_points);
-            }
-        }
-        if(mutex_lock)
-            unlock();
-        /**********************
-         * PREPARE CATEGORIES *
-         **********************/
-        if(specie_analysis_points.size() > 0)
-        {
-            std::vector<int> priority_sorted_category_ids;
-            for(auto it(avg_height_to_specie_id.rbegin()); it != avg_height_to_specie_id.rend(); it++)
-                priority_sorted_category_ids.push_back(it->second);
-
-            m_statistical_analyzer_config.setPrioritySortedCategoryIds(priority_sorted_category_ids);
-
-            unsigned long timestamp( Analyzer::analyze(tmp_dir.path(), specie_analysis_points, m_statistical_analyzer_config) );
-            Tracker::addEntry(timestamp, std::round(slope), humidities, illuminations, temperatures, elapsed_months, getSpecieIds(), tmp_dir);
-        }
-    }
-    else
-    {
-        qCritical() << "Failed to create temporary directory for statistical snapshot...";
-    }
     if(work_completion_listener)
         work_completion_listener->complete();
 }
@@ -446,3 +538,8 @@ void PlantStorage::unlock() const
     m_storage_accessor_mutex.unlock();
 }
 
+long long PlantStorage::takeLockWaitTime() const
+{
+    return m_storage_accessor_mutex.takeWaitTime();
+}
+
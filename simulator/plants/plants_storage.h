@@ -5,9 +5,10 @@
 #include <map>
 #include <unordered_set>
 #include <mutex>
+#include <memory>
+#include <atomic>
 
 #include "../../resources/environment_manager.h"
-#include <radialDistribution/analyser/analysis_configuration.h>
 #include "SpatialHashmap/spatial_hashmap.h"
 #include <QPoint>
 #include <QHash>
@@ -15,6 +16,16 @@
 #include <exception>
 
 #include "plant.h"
+#include "plant_columns.h"
+#include "seeding_index.h"
+#include "specie.h"
+#include "../../math/random_streams.h"
+#include "../../utils/thread_pool.h"
+#include "../../utils/timed_mutex.h"
+#include "../analysis/radial_distribution_analyzer.h"
+#ifndef HEADLESS_MODE
+#include "snapshot_rasterizer.h"
+#endif
 
 enum SortingCriteria{
     Strength,
@@ -31,8 +42,6 @@ class CallbackListener;
 class PlantStorage{
 public:
     typedef SpatialHashMap<LocationCell> PlantSpatialHashMap;
-    typedef std::unordered_map<int, Plant> BasePlantStorage;
-    typedef std::unordered_map<int, std::unordered_set<int> > SpecieQueryablePlants;
 
     class InvalidPlantIDException : public std::exception
     {
@@ -43,40 +52,81 @@ public:
         }
     };
 
-    PlantStorage(int area_width, int area_height);
+    PlantStorage(int area_width, int area_height, std::shared_ptr<const SpecieTable> p_specie_table);
     ~PlantStorage();
-    void add(const Plant & p_plant, bool mutex_lock = true);
+    void add(Plant & p_plant, bool mutex_lock = true); // Assigns the plant its unique id
     void remove(const Plant & plant, bool mutex_lock = true);
     void clear(bool mutex_lock = true);
     int getPlantCount() const;
     std::vector<Plant> getPlants(bool mutex_lock = true) const;
-    std::list<Plant> getSortedPlants(SortingCriteria p_sorting_criteria, bool mutex_lock = true) const;
+    std::vector<Plant> getSortedPlants(SortingCriteria p_sorting_criteria, bool mutex_lock = true) const;
     bool isPlantAtLocation(QPoint p_location, bool mutex_lock = true) const;
     std::set<int> getSpecieIds(bool mutex_lock = true) const;
-    std::vector<Plant> getOnePlantPerCell(int p_specie_id, bool mutex_lock = true) const;
+    std::map<int, int> getSpeciePlantCounts(bool mutex_lock = true) const; // Specie id --> plant count
+    std::vector<Plant> getOnePlantPerCell(int p_specie_id, RandomStream & p_random_stream, bool mutex_lock = true) const;
+    std::vector<Plant> getRandomPlants(int p_count, RandomStream & p_random_stream, bool mutex_lock = true) const; // Uniform, with replacement
     bool containsSpecie(int specie_id, bool mutex_lock = true) const;
+    /**
+     * Read-only view of the plant columns as they are now, taken in O(plants / chunk size). The simulation keeps
+     * going: it only copies the chunks it writes while the view still holds them, and rewrites the monthly updated
+     * columns into new chunks instead, see ChunkedColumn.
+     */
+    std::shared_ptr<const PlantColumns> getColumnsSnapshot(bool mutex_lock = true) const;
 
-    SpecieQueryablePlants getPlantsBySpecies();
-    void generateSnapshot(bool mutex_lock = true) const;
+#ifndef HEADLESS_MODE
+    void generateSnapshot(SnapshotSettings p_settings, bool mutex_lock = true) const;
+#endif
+    /**
+     * The entry is queued to the TrackerWriter, the listener being called once it is written.
+     * p_sample_budget: plants analysed per specie, 0 --> all. Approximate otherwise, see RadialDistributionAnalyzer
+     */
     void generateStatisticalSnapshot(float slope, std::vector<int> humidities, std::vector<int> illuminations, std::vector<int> temperatures, int elapsed_months,
-                                     CallbackListener * work_completion_listener = nullptr, bool mutex_lock = true);
-    void update(EnvironmentManager & environment_manager, std::vector<Plant> & surviving_plants, std::vector<Plant> & deceased_plants, bool mutex_lock = true);
+                                     int p_sample_budget = 0, CallbackListener * work_completion_listener = nullptr, bool mutex_lock = true);
+    /**
+     * Evaluates then commits a month. Setting p_cancel during the evaluation cancels the update: nothing is
+     * committed and false is returned.
+     */
+    bool update(EnvironmentManager & environment_manager, const RandomStreams & p_random_streams, int p_elapsed_months,
+                std::vector<Plant> & surviving_plants, std::vector<Plant> & deceased_plants, bool mutex_lock = true,
+                const std::atomic<bool> * p_cancel = nullptr);
+    void setThreadCount(int p_thread_count); // 0 --> One thread per core
+    long long takeLockWaitTime() const; // Nanoseconds spent waiting for the storage since the last call
 
 private:
+    /**
+     * Outcome of the monthly evaluation of a plant. Computed concurrently, applied serially.
+     */
+    struct PlantUpdate{
+        int strength;
+        int pain_enducer;
+        Plant::PlantStatus status;
+        float height;
+        float canopy_width;
+        float root_size;
+    };
+
+    void evaluate_plants(EnvironmentManager & environment_manager, const RandomStreams & p_random_streams, int p_elapsed_months,
+                         int p_from_slot, int p_to_slot);
+
     Plant operator[](int plant_id) const;
+    Plant get_plant(int slot) const;
     bool contains_plant(int plant_id, bool mutex_lock = true) const;
     void lock() const;
     void unlock() const;
 
-    BasePlantStorage m_plants;
-    SpecieQueryablePlants m_specie_id_queryable_plants;
+    std::shared_ptr<const SpecieTable> m_specie_table;
+    PlantColumns m_plants; // Chunks shared with snapshots, see getColumnsSnapshot
+    std::map<int, int> m_specie_id_plant_counts;
     PlantSpatialHashMap m_location_queryable_plants;
+    SeedingIndex m_seeding_index;
 
-    mutable std::mutex m_storage_accessor_mutex;
-    int m_plant_count;
+    mutable TimedMutex m_storage_accessor_mutex;
+    std::unique_ptr<ThreadPool> m_thread_pool;
+    std::shared_ptr<ThreadPool> m_analysis_thread_pool; // Statistical snapshots only, so they never hold up the simulation
+    std::vector<PlantUpdate> m_plant_updates;
     int m_area_width, m_area_height;
 
-    AnalysisConfiguration m_statistical_analyzer_config;
+    RadialDistributionAnalyzer m_radial_distribution_analyzer;
 };
 
 #endif //PLANT_STORAGE_H
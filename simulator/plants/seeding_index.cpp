@@ -0,0 +1,116 @@
+#include "seeding_index.h"
+#include "../../math/random_streams.h"
+#include <algorithm>
+
+SeedingIndex::SeedingIndex(int p_cell_size) : m_cell_size(p_cell_size)
+{
+
+}
+
+void SeedingIndex::add(int p_plant_id, int p_specie_id, const QPoint & p_position)
+{
+    if(p_plant_id >= m_memberships.size())
+        m_memberships.resize(p_plant_id+1, Membership{-1, 0, -1});
+
+    SpecieCells & specie(m_species[p_specie_id]);
+    long long cell(cell_key(p_position));
+
+    auto entry(specie.cell_entries.find(cell));
+    if(entry == specie.cell_entries.end())
+    {
+        entry = specie.cell_entries.emplace(cell, specie.cells.size()).first;
+        specie.cells.push_back(cell);
+        specie.members.push_back(std::vector<int>());
+    }
+
+    std::vector<int> & members(specie.members[entry->second]);
+    m_memberships[p_plant_id] = Membership{p_specie_id, cell, (int) members.size()};
+    members.push_back(p_plant_id);
+}
+
+void SeedingIndex::remove(int p_plant_id)
+{
+    if(p_plant_id < 0 || p_plant_id >= m_memberships.size() || m_memberships[p_plant_id].specie_id == -1)
+        return;
+
+    Membership & membership(m_memberships[p_plant_id]);
+    SpecieCells & specie(m_species[membership.specie_id]);
+    int entry(specie.cell_entries[membership.cell]);
+
+    // Move the last plant of the cell into the freed slot
+    std::vector<int> & members(specie.members[entry]);
+    members[membership.member_idx] = members.back();
+    m_memberships[members.back()].member_idx = membership.member_idx;
+    members.pop_back();
+
+    // Same for the cell once empty
+    if(members.empty())
+    {
+        int last(specie.cells.size()-1);
+        if(entry != last)
+        {
+            specie.cells[entry] = specie.cells[last];
+            specie.members[entry].swap(specie.members[last]);
+            specie.cell_entries[specie.cells[entry]] = entry;
+        }
+        specie.cell_entries.erase(membership.cell);
+        specie.cells.pop_back();
+        specie.members.pop_back();
+    }
+
+    membership = Membership{-1, 0, -1};
+}
+
+void SeedingIndex::clear()
+{
+    m_species.clear();
+    m_memberships.clear();
+}
+
+int SeedingIndex::getCellCount(int p_specie_id) const
+{
+    auto specie(m_species.find(p_specie_id));
+    return specie == m_species.end() ? 0 : specie->second.cells.size();
+}
+
+std::vector<int> SeedingIndex::drawOnePerCell(int p_specie_id, RandomStream & p_random_stream) const
+{
+    std::vector<int> plant_ids;
+    auto specie(m_species.find(p_specie_id));
+    if(specie == m_species.end())
+        return plant_ids;
+
+    // Least populated cells first, as seeding favours the first draws when capped. Populations are small integers:
+    // counting sort, stable so cells of equal population keep their index order
+    const std::vector<std::vector<int> > & cell_members(specie->second.members);
+    int max_population(0);
+    for(const std::vector<int> & members : cell_members)
+        max_population = std::max(max_population, (int) members.size());
+
+    std::vector<int> population_starts(max_population + 2, 0);
+    for(const std::vector<int> & members : cell_members)
+        population_starts[members.size() + 1]++;
+    for(int population(1); population < population_starts.size(); population++)
+        population_starts[population] += population_starts[population-1];
+
+    std::vector<int> cell_order(cell_members.size());
+    for(int i(0); i < cell_members.size(); i++)
+        cell_order[population_starts[cell_members[i].size()]++] = i;
+
+    plant_ids.reserve(cell_order.size());
+    for(int cell_idx : cell_order)
+    {
+        const std::vector<int> & members(cell_members[cell_idx]);
+        plant_ids.push_back(members[p_random_stream.uniformInt(0, members.size()-1)]);
+    }
+
+    return plant_ids;
+}
+
+/***********
+ * PRIVATE *
+ ***********/
+long long SeedingIndex::cell_key(const QPoint & p_position) const
+{
+    return (((long long) (p_position.x() / m_cell_size)) << 32) | (unsigned int) (p_position.y() / m_cell_size);
+}
@@ -0,0 +1,49 @@
+#ifndef SEEDING_INDEX_H
+#define SEEDING_INDEX_H
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <QPoint>
+
+class RandomStream;
+
+/**
+ * Plants of each specie grouped by cell, maintained on every add and remove. Per specie, the cells holding at least
+ * one of its plants are kept in a dense list, and the plants of each of those cells in a dense array. Both are
+ * swap-remove arrays so adding, removing and drawing a random plant of a cell are O(1).
+ */
+class SeedingIndex
+{
+public:
+    SeedingIndex(int p_cell_size);
+
+    void add(int p_plant_id, int p_specie_id, const QPoint & p_position);
+    void remove(int p_plant_id);
+    void clear();
+
+    int getCellCount(int p_specie_id) const; // Cells holding at least one plant of the specie
+    // Ids of one plant drawn uniformly from each cell holding the specie, by ascending cell population
+    std::vector<int> drawOnePerCell(int p_specie_id, RandomStream & p_random_stream) const;
+
+private:
+    struct SpecieCells{
+        std::vector<long long> cells; // Key of each occupied cell
+        std::vector<std::vector<int> > members; // Plant ids of each occupied cell
+        std::unordered_map<long long, int> cell_entries; // Cell key --> index in cells and members
+    };
+
+    struct Membership{
+        int specie_id; // -1 if the plant is not indexed
+        long long cell;
+        int member_idx;
+    };
+
+    long long cell_key(const QPoint & p_position) const;
+
+    int m_cell_size;
+    std::map<int, SpecieCells> m_species;
+    std::vector<Membership> m_memberships; // By plant id
+};
+
+#endif // SEEDING_INDEX_H
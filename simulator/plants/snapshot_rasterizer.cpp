@@ -0,0 +1,117 @@
+#include "snapshot_rasterizer.h"
+#include "specie.h"
+#include "../../utils/png_row_writer.h"
+#include "../../utils/thread_pool.h"
+
+#include <QDir>
+#include <set>
+#include <atomic>
+#include <math.h>
+
+/*********************
+ * SNAPSHOT SETTINGS *
+ *********************/
+SnapshotSettings::SnapshotSettings() : directory(QDir::homePath() + "/snapshots"), resolution(0)
+{
+
+}
+
+/***********************
+ * SNAPSHOT RASTERIZER *
+ ***********************/
+const int SnapshotRasterizer::_BAND_HEIGHT = 256;
+
+SnapshotRasterizer::SnapshotRasterizer(int p_area_width, int p_area_height, const SnapshotSettings & p_settings) :
+    m_directory(p_settings.directory),
+    m_width(p_settings.resolution > 0 ? p_settings.resolution : p_area_width),
+    m_scale(((float)m_width) / p_area_width),
+    m_height(std::max(1, (int) std::round(p_area_height * m_scale)))
+{
+
+}
+
+bool SnapshotRasterizer::write(const std::vector<SnapshotDisc> & p_discs, const SpecieTable & p_specie_table)
+{
+    if(!QDir().mkpath(m_directory))
+        return false;
+
+    // Pixel space discs, bucketed by band
+    std::set<int> specie_indices;
+    m_discs.clear();
+    m_discs.reserve(p_discs.size());
+    m_band_discs.assign((m_height + _BAND_HEIGHT - 1) / _BAND_HEIGHT, std::vector<int>());
+    for(const SnapshotDisc & disc : p_discs)
+    {
+        RasterDisc raster_disc;
+        raster_disc.x = std::round(disc.center.x() * m_scale);
+        raster_disc.y = std::round(disc.center.y() * m_scale);
+        raster_disc.radius = std::max(1, (int) std::round(disc.radius * m_scale));
+        raster_disc.color = p_specie_table[disc.specie_index].m_rgb;
+        raster_disc.specie_index = disc.specie_index;
+
+        int first_band(std::max(0, raster_disc.y - raster_disc.radius) / _BAND_HEIGHT);
+        int last_band(std::min(m_height-1, raster_disc.y + raster_disc.radius) / _BAND_HEIGHT);
+        for(int band(first_band); band <= last_band; band++)
+            m_band_discs[band].push_back(m_discs.size());
+
+        m_discs.push_back(raster_disc);
+        specie_indices.insert(disc.specie_index);
+    }
+
+    // Layer 0 holds all species
+    std::vector<int> layers(1, -1);
+    layers.insert(layers.end(), specie_indices.begin(), specie_indices.end());
+
+    std::atomic<bool> success(true);
+    ThreadPool thread_pool(std::min((int) layers.size(), ThreadPool::defaultThreadCount()));
+    thread_pool.run(layers.size(), [&](int p_layer, int p_thread_idx) {
+        int specie_index(layers[p_layer]);
+        QString filename(QString("%1/snapshot_%2.png").arg(m_directory)
+                         .arg(specie_index == -1 ? QString("all") : QString::number(p_specie_table[specie_index].m_specie_id)));
+        if(!write_layer(specie_index, filename))
+            success.store(false);
+    });
+
+    return success.load();
+}
+
+bool SnapshotRasterizer::write_layer(int p_specie_index, const QString & p_filename) const
+{
+    PngRowWriter writer(p_filename.toStdString(), m_width, m_height);
+    if(!writer.isOpen())
+        return false;
+
+    std::vector<QRgb> band(m_width * _BAND_HEIGHT);
+    for(int band_idx(0); band_idx < m_band_discs.size(); band_idx++)
+    {
+        int y_begin(band_idx * _BAND_HEIGHT);
+        int y_end(std::min(m_height, y_begin + _BAND_HEIGHT));
+        std::fill(band.begin(), band.end(), qRgb(0,0,0));
+
+        for(int disc_idx : m_band_discs[band_idx])
+        {
+            const RasterDisc & disc(m_discs[disc_idx]);
+            if(p_specie_index != -1 && disc.specie_index != p_specie_index)
+                continue;
+
+            // One horizontal span per row
+            for(int y(std::max(y_begin, disc.y - disc.radius)); y < std::min(y_end, disc.y + disc.radius + 1); y++)
+            {
+                int dy(y - disc.y);
+                int half_width(std::sqrt(disc.radius * disc.radius - dy * dy));
+                int x_begin(std::max(0, disc.x - half_width));
+                int x_end(std::min(m_width, disc.x + half_width + 1));
+                if(x_begin < x_end)
+                    std::fill(band.begin() + (y - y_begin) * m_width + x_begin, band.begin() + (y - y_begin) * m_width + x_end, disc.color);
+            }
+        }
+
+        for(int y(y_begin); y < y_end; y++)
+        {
+            if(!writer.writeRow(band.data() + (y - y_begin) * m_width))
+                return false;
+        }
+    }
+
+    return writer.finish();
+}
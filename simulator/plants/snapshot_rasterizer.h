@@ -0,0 +1,56 @@
+#ifndef SNAPSHOT_RASTERIZER_H
+#define SNAPSHOT_RASTERIZER_H
+
+#include <vector>
+#include <QString>
+#include <QPoint>
+#include <QRgb>
+
+class SpecieTable;
+
+struct SnapshotSettings{
+    QString directory;
+    int resolution; // Pixels per side of the terrain, 0 --> one pixel per centimeter
+
+    SnapshotSettings(); // ~/snapshots, one pixel per centimeter
+};
+
+struct SnapshotDisc{
+    QPoint center; // cm
+    float radius; // cm
+    int specie_index;
+};
+
+/**
+ * Rasterizes plant canopies into PNG files: one with all species, one per specie. No image is ever held whole:
+ * each layer is filled one band of rows at a time, every band being streamed to the encoder once complete.
+ * Layers are rasterized in parallel.
+ */
+class SnapshotRasterizer
+{
+public:
+    SnapshotRasterizer(int p_area_width, int p_area_height, const SnapshotSettings & p_settings);
+
+    // Discs are drawn in order, later ones on top. Returns false if any file could not be written
+    bool write(const std::vector<SnapshotDisc> & p_discs, const SpecieTable & p_specie_table);
+
+    static const int _BAND_HEIGHT; // Rows
+
+private:
+    struct RasterDisc{
+        int x, y, radius; // Pixels
+        QRgb color;
+        int specie_index;
+    };
+
+    bool write_layer(int p_specie_index, const QString & p_filename) const; // -1 --> all species
+
+    QString m_directory;
+    int m_width;
+    float m_scale; // Pixels per centimeter
+    int m_height;
+    std::vector<RasterDisc> m_discs;
+    std::vector<std::vector<int>> m_band_discs; // Indices of the discs overlapping each band, in drawing order
+};
+
+#endif // SNAPSHOT_RASTERIZER_H
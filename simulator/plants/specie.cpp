@@ -0,0 +1,205 @@
+#include "specie.h"
+#include "../../utils/utils.h"
+
+/**********
+ * SPECIE *
+ **********/
+Specie::Specie(const SpecieProperties & p_specie_properties, unsigned int p_rgb, int p_index) :
+    m_properties(p_specie_properties), m_specie_name(p_specie_properties.specie_name), m_specie_id(p_specie_properties.specie_id),
+    m_index(p_index), m_rgb(p_rgb),
+    m_growth_manager(p_specie_properties.growth_properties, p_specie_properties.ageing_properties),
+    m_constrainers(AgeConstrainer(p_specie_properties.ageing_properties),
+                   IlluminationConstrainer(p_specie_properties.illumination_properties),
+                   SoilHumidityConstrainer(p_specie_properties.soil_humidity_properties),
+                   TemperatureConstrainer(p_specie_properties.temperature_properties),
+                   SlopeConstrainer(p_specie_properties.slope_properties))
+{
+
+}
+
+Specie::~Specie()
+{
+
+}
+
+int Specie::calculateStrength(int p_age, int p_daily_illumination, int p_soil_humidity_percentage, int p_temp, int p_slope,
+                              Plant::ConstrainerType & p_bottleneck) const
+{
+    /*******
+     * AGE *
+     *******/
+    int min_strength (m_constrainers.age_constrainer.getStrength(p_age));
+    p_bottleneck = Plant::ConstrainerType::Age;
+
+    /****************
+     * ILLUMINATION *
+     ****************/
+    int illumination_strength (m_constrainers.illumination_constrainer.getStrength(p_daily_illumination));
+    if(illumination_strength < min_strength)
+    {
+        min_strength = illumination_strength;
+        p_bottleneck = Plant::ConstrainerType::Illumination;
+    }
+
+    /*****************
+     * SOIL HUMIDITY *
+     *****************/
+    int soil_humidity_strength (m_constrainers.soil_humidity_constrainer.getStrength(p_soil_humidity_percentage));
+    if(soil_humidity_strength < min_strength)
+    {
+        min_strength = soil_humidity_strength;
+        p_bottleneck = Plant::ConstrainerType::SoilHumidity;
+    }
+
+    /***************
+     * TEMPERATURE *
+     ***************/
+    int temp_strength (m_constrainers.temp_constrainer.getStrength(p_temp));
+    if(temp_strength < min_strength)
+    {
+        min_strength = temp_strength;
+        p_bottleneck = Plant::ConstrainerType::Temperature;
+    }
+
+    /*********
+     * SLOPE *
+     *********/
+    int slope_strength ( m_constrainers.slope_constrainer.getStrength(p_slope) );
+    if(slope_strength < min_strength)
+    {
+        min_strength = slope_strength;
+        p_bottleneck = Plant::ConstrainerType::Slope;
+    }
+
+    return min_strength;
+}
+
+Plant::PlantStatus Specie::getStatus(int p_strength, int p_random_id, Plant::ConstrainerType p_bottleneck,
+                                     int p_daily_illumination, int p_soil_humidity_percentage, int p_temp) const
+{
+    if(p_strength < 0 && p_random_id <= (p_strength * -1.f * 10)) // Die
+    {
+        switch(p_bottleneck){
+        case Plant::ConstrainerType::Illumination:
+            if(m_constrainers.illumination_constrainer.isUnderExposed(p_daily_illumination))
+                return Plant::PlantStatus::DeathByUnderIllumination;
+            else
+                return Plant::PlantStatus::DeathByOverIllumination;
+        case Plant::ConstrainerType::Age:
+            return Plant::PlantStatus::DeathByAge;
+        case Plant::ConstrainerType::SoilHumidity:
+            if (m_constrainers.soil_humidity_constrainer.isInDrought(p_soil_humidity_percentage))
+                return Plant::PlantStatus::DeathByDrought;
+            else
+                return Plant::PlantStatus::DeathByFlood;
+        case Plant::ConstrainerType::Temperature:
+            if(m_constrainers.temp_constrainer.isTooCold(p_temp))
+                return Plant::PlantStatus::DeathByCold;
+            else
+                return Plant::PlantStatus::DeathByHeat;
+        case Plant::ConstrainerType::Slope:
+                return Plant::PlantStatus::DeathBySlope;
+        }
+    }
+    return Plant::PlantStatus::Alive;
+}
+
+int Specie::getMinimumSoilHumidityRequirement() const
+{
+    return m_constrainers.soil_humidity_constrainer.getMinimumPrimeSoilHumidity();
+}
+
+QPoint Specie::seed(QPoint p_center_position, RandomStream & p_random_stream) const
+{
+    int max_distance(m_properties.seeding_properties.max_seed_distance * 100); // To centimeters
+
+    return Utils::getRandomPointInCircle(p_center_position, max_distance, p_random_stream);
+}
+
+/****************
+ * SPECIE TABLE *
+ ****************/
+SpecieTable::SpecieTable(const PlantDB::SpeciePropertiesHolder & p_specie_properties) :
+    m_species(), m_specie_id_to_index()
+{
+    std::vector<unsigned int> colors(get_specie_colors());
+
+    m_species.reserve(p_specie_properties.size());
+    for(auto it(p_specie_properties.begin()); it != p_specie_properties.end(); it++)
+    {
+        int index(m_species.size());
+        m_species.push_back(Specie(it->second, colors.at(index % colors.size()), index));
+        m_specie_id_to_index.emplace(it->first, index);
+    }
+}
+
+SpecieTable::~SpecieTable()
+{
+
+}
+
+std::shared_ptr<const SpecieTable> SpecieTable::load()
+{
+    return std::shared_ptr<const SpecieTable>(new SpecieTable(PlantDB().getAllPlantData()));
+}
+
+const Specie & SpecieTable::operator[](int p_index) const
+{
+    return m_species[p_index];
+}
+
+const Specie & SpecieTable::getBySpecieId(int p_specie_id) const
+{
+    return m_species[getIndex(p_specie_id)];
+}
+
+int SpecieTable::getIndex(int p_specie_id) const
+{
+    auto it(m_specie_id_to_index.find(p_specie_id));
+
+    if(it != m_specie_id_to_index.end())
+        return it->second;
+
+    throw SpecieTable::InvalidSpecieIDException();
+}
+
+bool SpecieTable::contains(int p_specie_id) const
+{
+    return m_specie_id_to_index.find(p_specie_id) != m_specie_id_to_index.end();
+}
+
+int SpecieTable::size() const
+{
+    return m_species.size();
+}
+
+std::vector<Specie>::const_iterator SpecieTable::begin() const
+{
+    return m_species.begin();
+}
+
+std::vector<Specie>::const_iterator SpecieTable::end() const
+{
+    return m_species.end();
+}
+
+// Qt's global colors
+std::vector<unsigned int> SpecieTable::get_specie_colors()
+{
+    std::vector<unsigned int> ret;
+    ret.push_back(0xffffffff); // white
+    ret.push_back(0xffff0000); // red
+    ret.push_back(0xff00ff00); // green
+    ret.push_back(0xff0000ff); // blue
+    ret.push_back(0xff00ffff); // cyan
+    ret.push_back(0xffff00ff); // magenta
+    ret.push_back(0xffffff00); // yellow
+    ret.push_back(0xff800000); // darkRed
+    ret.push_back(0xff008000); // darkGreen
+    ret.push_back(0xff000080); // darkBlue
+    ret.push_back(0xff008080); // darkCyan
+    ret.push_back(0xff800080); // darkMagenta
+    ret.push_back(0xff808000); // darkYellow
+
+    return ret;
+}
@@ -0,0 +1,76 @@
+#ifndef SPECIE_H
+#define SPECIE_H
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <QPoint>
+#include "plantDB/plant_properties.h"
+#include "plantDB/plant_db.h"
+#include "growth_manager.h"
+#include "constrainers.h"
+#include "plant.h"
+#include "../../math/random_streams.h"
+
+/**********
+ * SPECIE *
+ **********/
+class Specie {
+public:
+    Specie(const SpecieProperties & p_specie_properties, unsigned int p_rgb, int p_index);
+    ~Specie();
+
+    int calculateStrength(int p_age, int p_daily_illumination, int p_soil_humidity_percentage, int p_temp, int p_slope,
+                          Plant::ConstrainerType & p_bottleneck) const;
+    Plant::PlantStatus getStatus(int p_strength, int p_random_id, Plant::ConstrainerType p_bottleneck,
+                                 int p_daily_illumination, int p_soil_humidity_percentage, int p_temp) const;
+    int getMinimumSoilHumidityRequirement() const;
+    QPoint seed(QPoint p_center_position, RandomStream & p_random_stream) const;
+
+    const SpecieProperties m_properties;
+    const QString m_specie_name;
+    const int m_specie_id;
+    const int m_index; // Position in the specie table
+    const unsigned int m_rgb; // As a QRgb, kept free of QtGui for headless builds
+    const GrowthManager m_growth_manager;
+
+private:
+    ConstrainersWrapper m_constrainers;
+};
+
+/****************
+ * SPECIE TABLE *
+ ****************/
+class SpecieTable {
+public:
+    class InvalidSpecieIDException : public std::exception
+    {
+    public:
+        virtual const char* what() const noexcept
+        {
+            return "Requested invalid specie id!";
+        }
+    };
+
+    SpecieTable(const PlantDB::SpeciePropertiesHolder & p_specie_properties);
+    ~SpecieTable();
+
+    static std::shared_ptr<const SpecieTable> load(); // From the plant database
+
+    const Specie & operator[](int p_index) const;
+    const Specie & getBySpecieId(int p_specie_id) const;
+    int getIndex(int p_specie_id) const;
+    bool contains(int p_specie_id) const;
+    int size() const;
+
+    std::vector<Specie>::const_iterator begin() const;
+    std::vector<Specie>::const_iterator end() const;
+
+private:
+    static std::vector<unsigned int> get_specie_colors();
+
+    std::vector<Specie> m_species;
+    std::map<int, int> m_specie_id_to_index;
+};
+
+#endif // SPECIE_H
@@ -0,0 +1,81 @@
+#include "png_row_writer.h"
+#include <png.h>
+
+/*
+ * libpng reports errors by jumping back to the last setjmp: every call into it is guarded.
+ */
+PngRowWriter::PngRowWriter(const std::string & p_filename, int p_width, int p_height) :
+    m_file(std::fopen(p_filename.c_str(), "wb")), m_png(nullptr), m_info(nullptr), m_width(p_width), m_height(p_height),
+    m_written_rows(0), m_row(p_width * 3), m_failed(true)
+{
+    if(!m_file)
+        return;
+
+    m_png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    if(!m_png)
+        return;
+    m_info = png_create_info_struct(m_png);
+    if(!m_info)
+        return;
+
+    if(setjmp(png_jmpbuf(m_png)))
+        return;
+    png_init_io(m_png, m_file);
+    png_set_IHDR(m_png, m_info, m_width, m_height, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+                 PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(m_png, m_info);
+    m_failed = false;
+}
+
+PngRowWriter::~PngRowWriter()
+{
+    if(m_png)
+        png_destroy_write_struct(&m_png, m_info ? &m_info : nullptr);
+    if(m_file)
+        std::fclose(m_file);
+}
+
+bool PngRowWriter::isOpen() const
+{
+    return !m_failed;
+}
+
+bool PngRowWriter::writeRow(const QRgb * p_row)
+{
+    if(m_failed || m_written_rows == m_height)
+        return false;
+
+    for(int x(0); x < m_width; x++)
+    {
+        m_row[x*3] = qRed(p_row[x]);
+        m_row[x*3+1] = qGreen(p_row[x]);
+        m_row[x*3+2] = qBlue(p_row[x]);
+    }
+
+    if(setjmp(png_jmpbuf(m_png)))
+    {
+        m_failed = true;
+        return false;
+    }
+    png_write_row(m_png, m_row.data());
+    m_written_rows++;
+    return true;
+}
+
+bool PngRowWriter::finish()
+{
+    if(m_failed || m_written_rows != m_height)
+        return false;
+
+    if(setjmp(png_jmpbuf(m_png)))
+    {
+        m_failed = true;
+        return false;
+    }
+    png_write_end(m_png, nullptr);
+
+    bool closed(std::fclose(m_file) == 0);
+    m_file = nullptr;
+    m_failed = !closed;
+    return closed;
+}
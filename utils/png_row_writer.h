@@ -0,0 +1,35 @@
+#ifndef PNG_ROW_WRITER_H
+#define PNG_ROW_WRITER_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <QRgb>
+
+struct png_struct_def;
+struct png_info_def;
+
+/**
+ * Encodes an RGB PNG file row by row, top to bottom: only the row being written is held in memory.
+ */
+class PngRowWriter
+{
+public:
+    PngRowWriter(const std::string & p_filename, int p_width, int p_height);
+    ~PngRowWriter();
+
+    bool isOpen() const;
+    bool writeRow(const QRgb * p_row); // p_width pixels
+    bool finish(); // Once every row has been written
+
+private:
+    std::FILE * m_file;
+    png_struct_def * m_png;
+    png_info_def * m_info;
+    int m_width, m_height;
+    int m_written_rows;
+    std::vector<unsigned char> m_row; // RGB
+    bool m_failed;
+};
+
+#endif // PNG_ROW_WRITER_H
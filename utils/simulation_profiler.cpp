@@ -0,0 +1,184 @@
+#include "simulation_profiler.h"
+
+#include <cmath>
+#include <algorithm>
+
+/*****************
+ * MONTH PROFILE *
+ *****************/
+SimulationProfiler::MonthProfile::MonthProfile() : month(-1), total_time(0)
+{
+    for(int i(0); i < _N_PHASES; i++)
+        phase_times[i] = 0;
+    for(int i(0); i < _N_COUNTERS; i++)
+        counters[i] = 0;
+    for(int i(0); i < _N_LOCKS; i++)
+        lock_wait_times[i] = 0;
+}
+
+/****************
+ * SCOPED PHASE *
+ ****************/
+SimulationProfiler::ScopedPhase::ScopedPhase(SimulationProfiler & p_profiler, Phase p_phase) :
+    m_profiler(p_profiler), m_phase(p_phase), m_enabled(p_profiler.isEnabled()), m_trace(getPhaseName(p_phase))
+{
+    if(m_enabled)
+        m_start = std::chrono::steady_clock::now();
+}
+
+SimulationProfiler::ScopedPhase::~ScopedPhase()
+{
+    if(m_enabled)
+        m_profiler.m_current.phase_times[m_phase] +=
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count() / 1000.0;
+}
+
+/***********************
+ * SIMULATION PROFILER *
+ ***********************/
+SimulationProfiler::SimulationProfiler(int p_window_size) : m_enabled(false), m_window_size(p_window_size), m_current(), m_window()
+{
+
+}
+
+void SimulationProfiler::setEnabled(bool p_enabled)
+{
+    m_enabled.store(p_enabled);
+}
+
+bool SimulationProfiler::isEnabled() const
+{
+    return m_enabled.load();
+}
+
+void SimulationProfiler::beginMonth(int p_month)
+{
+    m_current = MonthProfile();
+    m_current.month = p_month;
+    if(isEnabled())
+        m_month_start = std::chrono::steady_clock::now();
+}
+
+void SimulationProfiler::endMonth()
+{
+    if(!isEnabled() || m_current.month == -1)
+        return;
+
+    m_current.total_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_month_start).count() / 1000.0;
+
+    std::lock_guard<std::mutex> lock(m_window_mutex);
+    m_window.push_back(m_current);
+    while(m_window.size() > m_window_size)
+        m_window.pop_front();
+}
+
+void SimulationProfiler::addCount(Counter p_counter, long p_count)
+{
+    if(isEnabled())
+        m_current.counters[p_counter] += p_count;
+}
+
+void SimulationProfiler::addLockWait(Lock p_lock, long long p_wait_time_ns)
+{
+    if(isEnabled())
+        m_current.lock_wait_times[p_lock] += p_wait_time_ns / 1000000.0;
+}
+
+void SimulationProfiler::clear()
+{
+    std::lock_guard<std::mutex> lock(m_window_mutex);
+    m_window.clear();
+}
+
+bool SimulationProfiler::hasProfiles() const
+{
+    std::lock_guard<std::mutex> lock(m_window_mutex);
+    return !m_window.empty();
+}
+
+SimulationProfiler::MonthProfile SimulationProfiler::getLastMonth() const
+{
+    std::lock_guard<std::mutex> lock(m_window_mutex);
+    return m_window.empty() ? MonthProfile() : m_window.back();
+}
+
+std::vector<SimulationProfiler::MonthProfile> SimulationProfiler::getWindow() const
+{
+    std::lock_guard<std::mutex> lock(m_window_mutex);
+    return std::vector<MonthProfile>(m_window.begin(), m_window.end());
+}
+
+std::vector<int> SimulationProfiler::getHistogram(Phase p_phase) const
+{
+    std::vector<int> histogram(_N_HISTOGRAM_BUCKETS, 0);
+
+    std::lock_guard<std::mutex> lock(m_window_mutex);
+    for(const MonthProfile & profile : m_window)
+        histogram[getHistogramBucket(profile.phase_times[p_phase])]++;
+
+    return histogram;
+}
+
+std::vector<int> SimulationProfiler::getMonthHistogram() const
+{
+    std::vector<int> histogram(_N_HISTOGRAM_BUCKETS, 0);
+
+    std::lock_guard<std::mutex> lock(m_window_mutex);
+    for(const MonthProfile & profile : m_window)
+        histogram[getHistogramBucket(profile.total_time)]++;
+
+    return histogram;
+}
+
+int SimulationProfiler::getHistogramBucket(double p_time_ms)
+{
+    double time_us(p_time_ms * 1000);
+    if(time_us < 2)
+        return 0;
+
+    return std::min(_N_HISTOGRAM_BUCKETS-1, (int) std::log2(time_us));
+}
+
+const char * SimulationProfiler::getPhaseName(Phase p_phase)
+{
+    switch(p_phase){
+        case PlantUpdate:
+            return "plant_update";
+        case EnvironmentUpdate:
+            return "environment_update";
+        case DeceasedRemoval:
+            return "deceased_removal";
+        case Seeding:
+            return "seeding";
+        case RenderingData:
+            return "rendering_data";
+    default:
+        return "unknown";
+    }
+}
+
+const char * SimulationProfiler::getCounterName(Counter p_counter)
+{
+    switch(p_counter){
+        case PlantsEvaluated:
+            return "plants_evaluated";
+        case CellsTouched:
+            return "cells_touched";
+        case PlantsBorn:
+            return "plants_born";
+        case PlantsKilled:
+            return "plants_killed";
+    default:
+        return "unknown";
+    }
+}
+
+const char * SimulationProfiler::getLockName(Lock p_lock)
+{
+    switch(p_lock){
+        case PlantStorageLock:
+            return "plant_storage";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef SIMULATION_PROFILER_H
+#define SIMULATION_PROFILER_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include "trace_recorder.h"
+
+/**
+ * Per-month instrumentation of the simulation step: wall time per phase, event counts and lock wait times.
+ * The last months are kept in a rolling window from which histograms are built. Recording is done by the
+ * simulation thread only; the window can be read from any thread. When disabled, a phase costs one flag check.
+ */
+class SimulationProfiler
+{
+public:
+    enum Phase{
+        PlantUpdate,
+        EnvironmentUpdate,
+        DeceasedRemoval,
+        Seeding,
+        RenderingData,
+        _N_PHASES
+    };
+
+    enum Counter{
+        PlantsEvaluated,
+        CellsTouched,
+        PlantsBorn,
+        PlantsKilled,
+        _N_COUNTERS
+    };
+
+    enum Lock{
+        PlantStorageLock,
+        _N_LOCKS
+    };
+
+    struct MonthProfile{
+        int month;
+        double total_time; // ms
+        double phase_times[_N_PHASES]; // ms
+        long counters[_N_COUNTERS];
+        double lock_wait_times[_N_LOCKS]; // ms
+
+        MonthProfile();
+    };
+
+    /**
+     * Times the enclosing scope as the given phase. The phase is also traced, if a trace is being recorded.
+     */
+    class ScopedPhase
+    {
+    public:
+        ScopedPhase(SimulationProfiler & p_profiler, Phase p_phase);
+        ~ScopedPhase();
+
+    private:
+        SimulationProfiler & m_profiler;
+        Phase m_phase;
+        bool m_enabled;
+        std::chrono::steady_clock::time_point m_start;
+        TraceRecorder::Scope m_trace;
+    };
+
+    static const int _N_HISTOGRAM_BUCKETS = 24; // Bucket i: [2^i, 2^(i+1)) microseconds, the first one also holds shorter times
+
+    SimulationProfiler(int p_window_size = 120);
+
+    void setEnabled(bool p_enabled);
+    bool isEnabled() const;
+
+    void beginMonth(int p_month);
+    void endMonth(); // Commits the month to the rolling window
+    void addCount(Counter p_counter, long p_count);
+    void addLockWait(Lock p_lock, long long p_wait_time_ns);
+    void clear();
+
+    bool hasProfiles() const;
+    MonthProfile getLastMonth() const;
+    std::vector<MonthProfile> getWindow() const;
+    std::vector<int> getHistogram(Phase p_phase) const; // Over the rolling window
+    std::vector<int> getMonthHistogram() const; // Total month times over the rolling window
+
+    static const char * getPhaseName(Phase p_phase);
+    static const char * getCounterName(Counter p_counter);
+    static const char * getLockName(Lock p_lock);
+    static int getHistogramBucket(double p_time_ms);
+
+private:
+    std::atomic<bool> m_enabled;
+    int m_window_size;
+    MonthProfile m_current;
+    std::chrono::steady_clock::time_point m_month_start;
+
+    mutable std::mutex m_window_mutex;
+    std::deque<MonthProfile> m_window;
+};
+
+#endif // SIMULATION_PROFILER_H
@@ -0,0 +1,94 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include <algorithm>
+#include <utility>
+
+/**
+ * Vector of trivially copyable elements storing up to N of them inline, only spilling to the heap beyond.
+ * Intended for the short per-cell lists of the environment grid.
+ */
+template <class T, int N> class SmallVector {
+public:
+    SmallVector() : m_data(m_inline), m_size(0), m_capacity(N) {}
+
+    SmallVector(const SmallVector & other) : m_data(m_inline), m_size(0), m_capacity(N)
+    {
+        copy_from(other);
+    }
+
+    SmallVector & operator=(const SmallVector & other)
+    {
+        if(this != &other)
+        {
+            m_size = 0;
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector()
+    {
+        if(m_data != m_inline)
+            delete [] m_data;
+    }
+
+    int size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    T & operator[](int p_idx) { return m_data[p_idx]; }
+    const T & operator[](int p_idx) const { return m_data[p_idx]; }
+
+    T * begin() { return m_data; }
+    T * end() { return m_data + m_size; }
+    const T * begin() const { return m_data; }
+    const T * end() const { return m_data + m_size; }
+
+    void push_back(const T & p_value)
+    {
+        if(m_size == m_capacity)
+            grow(m_capacity * 2);
+        m_data[m_size++] = p_value;
+    }
+
+    // Moves the last element into the freed slot: does not preserve order
+    void swapRemove(int p_idx)
+    {
+        m_data[p_idx] = m_data[--m_size];
+    }
+
+    // Shifts the following elements: preserves order
+    void erase(int p_idx)
+    {
+        std::copy(m_data + p_idx + 1, m_data + m_size, m_data + p_idx);
+        m_size--;
+    }
+
+    void clear() { m_size = 0; }
+
+private:
+    void grow(int p_capacity)
+    {
+        T * data(new T[p_capacity]);
+        std::copy(m_data, m_data + m_size, data);
+        if(m_data != m_inline)
+            delete [] m_data;
+        m_data = data;
+        m_capacity = p_capacity;
+    }
+
+    void copy_from(const SmallVector & other)
+    {
+        if(other.m_size > m_capacity)
+            grow(other.m_size);
+        std::copy(other.m_data, other.m_data + other.m_size, m_data);
+        m_size = other.m_size;
+    }
+
+    T m_inline[N];
+    T * m_data;
+    int m_size;
+    int m_capacity;
+};
+
+#endif // SMALL_VECTOR_H
@@ -0,0 +1,99 @@
+#include "thread_pool.h"
+#include "trace_recorder.h"
+
+ThreadPool::ThreadPool(int p_thread_count) : m_task_count(0), m_next_task(0), m_completed_tasks(0), m_busy_workers(0),
+    m_generation(0), m_stop(false)
+{
+    // The calling thread is the first worker
+    for(int i(1); i < p_thread_count; i++)
+        m_workers.push_back(std::thread(&ThreadPool::worker_loop, this, i));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_available.notify_all();
+
+    for(std::thread & worker : m_workers)
+        worker.join();
+}
+
+int ThreadPool::getThreadCount() const
+{
+    return m_workers.size() + 1;
+}
+
+int ThreadPool::defaultThreadCount()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::run(int p_task_count, Task p_task)
+{
+    std::lock_guard<std::mutex> run_lock(m_run_mutex);
+    if(m_workers.empty()) // Nothing to distribute
+    {
+        for(int i(0); i < p_task_count; i++)
+            p_task(i, 0);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Workers still draining the previous batch may be reading the task
+        m_work_complete.wait(lock, [this]{ return m_busy_workers == 0; });
+        m_task = p_task;
+        m_task_count = p_task_count;
+        m_next_task.store(0);
+        m_completed_tasks.store(0);
+        m_generation++;
+    }
+    m_work_available.notify_all();
+
+    execute_tasks(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_work_complete.wait(lock, [this]{ return m_completed_tasks.load() == m_task_count && m_busy_workers == 0; });
+    m_task = Task();
+}
+
+/***********
+ * PRIVATE *
+ ***********/
+void ThreadPool::worker_loop(int p_thread_idx)
+{
+    TraceRecorder::setThreadName("thread_pool_worker");
+    long processed_generation(0);
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_work_available.wait(lock, [this, processed_generation]{ return m_stop || m_generation != processed_generation; });
+            if(m_stop)
+                return;
+            processed_generation = m_generation;
+            m_busy_workers++;
+        }
+
+        execute_tasks(p_thread_idx);
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_busy_workers--;
+        }
+        m_work_complete.notify_all();
+    }
+}
+
+void ThreadPool::execute_tasks(int p_thread_idx)
+{
+    int task;
+    while((task = m_next_task.fetch_add(1)) < m_task_count)
+    {
+        m_task(task, p_thread_idx);
+        m_completed_tasks.fetch_add(1);
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/**
+ * Fixed set of long-lived worker threads. Work is submitted as a batch of independent tasks
+ * which are pulled by the workers (and by the calling thread) until the batch is exhausted.
+ * Batches submitted concurrently run one after the other.
+ */
+class ThreadPool
+{
+public:
+    // Task index, index of the thread running it (0 is the calling thread)
+    typedef std::function<void(int, int)> Task;
+
+    ThreadPool(int p_thread_count);
+    ~ThreadPool();
+
+    int getThreadCount() const;
+    void run(int p_task_count, Task p_task); // Blocks until all tasks have completed
+
+    static int defaultThreadCount();
+
+private:
+    void worker_loop(int p_thread_idx);
+    void execute_tasks(int p_thread_idx);
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_run_mutex; // One batch at a time
+    std::mutex m_mutex;
+    std::condition_variable m_work_available;
+    std::condition_variable m_work_complete;
+
+    Task m_task;
+    int m_task_count;
+    std::atomic<int> m_next_task;
+    std::atomic<int> m_completed_tasks;
+    int m_busy_workers;
+    long m_generation;
+    bool m_stop;
+};
+
+#endif // THREAD_POOL_H
@@ -1,45 +1,73 @@
 #include "time_manager.h"
-#include <time.h>
-#include <chrono>
-#include <ctime>
 #include <iostream>
+#include "trace_recorder.h"
 
-#define SLEEP_TIME 20
-
-TimeManager::TimeManager() : m_unit_time(-1), m_listeners(), m_time_keeper(NULL)
+TimeManager::TimeManager(const char * p_name) : m_name(p_name), m_listeners(), m_unit_time(-1), m_mode(Periodic), m_running(false),
+    m_ticking(false), m_tick_requested(false), m_exit(false)
 {
 }
 
 TimeManager::~TimeManager()
 {
-    stop();
-    if(m_time_keeper)
     {
-        m_time_keeper->join();
-        delete m_time_keeper;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+        m_exit = true;
     }
+    m_condition.notify_all();
+    if(m_time_keeper.joinable())
+        m_time_keeper.join();
 }
 
 void TimeManager::start()
 {
-    if(m_unit_time.load() != -1)
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_mode != AsFastAsPossible && m_unit_time == -1)
     {
-        m_stop.store(false);
-        m_time_keeper = new std::thread(&TimeManager::process_one_unit_time, this);
-    }
-    else
         std::cerr << "First you must set a unit time!" << std::endl;
+        return;
+    }
+
+    m_running = true;
+    m_last_tick = Clock::now();
+    m_next_tick = (m_mode == Coalescing ? m_last_tick : m_last_tick + std::chrono::milliseconds(m_unit_time));
+    if(!m_time_keeper.joinable())
+        m_time_keeper = std::thread(&TimeManager::run, this);
+    m_condition.notify_all();
 }
 
 void TimeManager::stop()
 {
-    m_stop.store(true);
-    std::this_thread::sleep_for(std::chrono::milliseconds(SLEEP_TIME*2)); // Ensure the timer has stopped
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_running = false;
+    m_tick_requested = false;
+    m_condition.notify_all();
+
+    // A listener stopping its own timer must not wait for itself
+    if(std::this_thread::get_id() != m_time_keeper.get_id())
+        m_condition.wait(lock, [this]{ return !m_ticking; });
 }
 
 void TimeManager::setUnitTime(int p_unit_time_ms)
 {
-    m_unit_time.store(p_unit_time_ms);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_unit_time = p_unit_time_ms;
+    m_next_tick = m_last_tick + std::chrono::milliseconds(m_unit_time);
+    m_condition.notify_all();
+}
+
+void TimeManager::setMode(Mode p_mode)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mode = p_mode;
+    m_condition.notify_all();
+}
+
+void TimeManager::requestTick()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tick_requested = true;
+    m_condition.notify_all();
 }
 
 void TimeManager::addListener(TimeManager::TimeListener * p_listener)
@@ -50,33 +78,58 @@ void TimeManager::addListener(TimeManager::TimeListener * p_listener)
 /***********
  * PRIVATE *
  ***********/
-void TimeManager::process_one_unit_time()
+void TimeManager::run()
 {
-    using namespace std::chrono;
-
-    auto t_start = high_resolution_clock::now();
-    std::chrono::milliseconds sleep_time(SLEEP_TIME);
+    TraceRecorder::setThreadName(m_name);
 
-    high_resolution_clock::time_point t_end;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(!m_exit)
+    {
+        Clock::time_point now(Clock::now());
+        if(!tick_due(now))
+        {
+            // Woken up early by any change of state
+            if(!m_running || m_mode == AsFastAsPossible || (m_mode == Coalescing && !m_tick_requested))
+                m_condition.wait(lock);
+            else
+                m_condition.wait_until(lock, m_next_tick);
+            continue;
+        }
 
-    do{
-        std::this_thread::sleep_for(sleep_time);
-        t_end = t_start + std::chrono::milliseconds(m_unit_time.load());
-    }while(!m_stop.load() && std::chrono::high_resolution_clock::now() < t_end);
+        m_last_tick = (m_mode == Periodic ? m_next_tick : now);
+        m_tick_requested = false;
+        m_ticking = true;
+        lock.unlock();
+        callback_listeners();
+        lock.lock();
+        m_ticking = false;
+        m_condition.notify_all();
 
-    if(!m_stop.load())
-        unit_time_complete_callback();
+        m_next_tick = m_last_tick + std::chrono::milliseconds(m_unit_time);
+        // A periodic tick which overran its period is not caught up with a burst of ticks
+        if(m_mode == Periodic)
+            m_next_tick = std::max(m_next_tick, Clock::now());
+    }
 }
 
-void TimeManager::unit_time_complete_callback()
+bool TimeManager::tick_due(Clock::time_point p_now) const
 {
-    callback_listeners();
-    if(!m_stop.load()) // continue to run
-        start();
+    if(!m_running)
+        return false;
+
+    switch(m_mode){
+        case AsFastAsPossible:
+            return true;
+        case Coalescing:
+            return m_tick_requested && p_now >= m_next_tick;
+    default:
+        return p_now >= m_next_tick;
+    }
 }
 
 void TimeManager::callback_listeners()
 {
+    TraceRecorder::Scope trace("tick");
     for(TimeManager::TimeListener * l : m_listeners)
         l->trigger();
 }
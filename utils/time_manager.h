@@ -2,11 +2,14 @@
 #define TIME_MANAGER_H
 
 #include <vector>
-#include <atomic>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
-#define CLOCKS_PER_MILLISECONDS CLOCKS_PER_SEC/1000
-
+/**
+ * Calls its listeners from a single long-lived thread, created on the first start.
+ */
 class TimeManager
 {
 public:
@@ -16,24 +19,42 @@ public:
         virtual void trigger() = 0;
     };
 
-    TimeManager();
+    enum Mode{
+        Periodic, // One tick per unit time, scheduled on fixed deadlines
+        AsFastAsPossible, // Ticks back to back
+        Coalescing // Ticks on request, at most one per unit time: requests made meanwhile are merged
+    };
+
+    TimeManager(const char * p_name = "time_manager"); // Name of the timer thread in traces
     ~TimeManager();
 
     void addListener(TimeManager::TimeListener* p_listener);
     void start();
-    void stop();
+    void stop(); // Returns as soon as the tick in progress, if any, has completed
     void setUnitTime(int p_unit_time_ms);
-    static const int _FASTEST;
+    void setMode(Mode p_mode);
+    void requestTick(); // Coalescing mode
 
 private:
-    std::atomic<int> m_unit_time;
-    std::atomic<bool> m_stop;
+    typedef std::chrono::steady_clock Clock;
 
+    const char * m_name;
     std::vector<TimeManager::TimeListener*> m_listeners;
-    std::thread * m_time_keeper;
 
-    void process_one_unit_time();
-    void unit_time_complete_callback();
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    int m_unit_time;
+    Mode m_mode;
+    bool m_running;
+    bool m_ticking;
+    bool m_tick_requested;
+    bool m_exit;
+    Clock::time_point m_last_tick;
+    Clock::time_point m_next_tick;
+    std::thread m_time_keeper;
+
+    void run();
+    bool tick_due(Clock::time_point p_now) const;
     void callback_listeners();
 };
 
@@ -0,0 +1,52 @@
+#ifndef TIMED_MUTEX_H
+#define TIMED_MUTEX_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include "trace_recorder.h"
+
+/**
+ * Mutex accumulating the time spent waiting for it. Only contended acquisitions are timed: an uncontended
+ * lock costs a single try_lock. Waits also appear in the trace, if one is being recorded.
+ */
+class TimedMutex
+{
+public:
+    TimedMutex(const char * p_name) : m_name(p_name), m_mutex(), m_wait_time(0) {}
+
+    void lock()
+    {
+        if(m_mutex.try_lock())
+            return;
+
+        auto start(TraceRecorder::Clock::now());
+        m_mutex.lock();
+        auto end(TraceRecorder::Clock::now());
+        m_wait_time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        TraceRecorder::record(m_name, start, end);
+    }
+
+    bool try_lock()
+    {
+        return m_mutex.try_lock();
+    }
+
+    void unlock()
+    {
+        m_mutex.unlock();
+    }
+
+    // Nanoseconds waited since the last call
+    long long takeWaitTime()
+    {
+        return m_wait_time.exchange(0);
+    }
+
+private:
+    const char * m_name;
+    std::mutex m_mutex;
+    std::atomic<long long> m_wait_time;
+};
+
+#endif // TIMED_MUTEX_H
@@ -0,0 +1,255 @@
+#include "trace_recorder.h"
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+
+namespace {
+    struct TraceEvent{
+        const char * name;
+        long long start; // us
+        long long duration; // us
+    };
+
+    /**
+     * Written by its thread only. The size is published after the event so the chunk can be read concurrently.
+     */
+    struct TraceChunk{
+        static const int _CAPACITY = 512;
+
+        TraceEvent events[_CAPACITY];
+        std::atomic<int> size;
+        std::atomic<TraceChunk*> next;
+
+        TraceChunk() : size(0), next(nullptr) {}
+    };
+
+    /**
+     * Owned by the registry until the process exits, so a thread can never be left writing to freed memory. Reset
+     * in place by its thread when first used in a new recording, and recycled by another thread once its own has
+     * ended and its events belong to a previous recording.
+     */
+    struct ThreadTrace{
+        int tid;
+        const char * name;
+        int generation; // Recording the events belong to
+        bool in_use; // By a running thread
+        TraceChunk head;
+        TraceChunk * tail;
+
+        ThreadTrace(int p_tid) : tid(p_tid), name(nullptr), generation(-1), in_use(true), head(), tail(&head) {}
+        ~ThreadTrace()
+        {
+            free_chunks();
+        }
+
+        // Registry lock held
+        void reset(int p_generation)
+        {
+            free_chunks();
+            head.next.store(nullptr);
+            head.size.store(0);
+            tail = &head;
+            generation = p_generation;
+        }
+
+    private:
+        void free_chunks()
+        {
+            TraceChunk * chunk(head.next.load());
+            while(chunk)
+            {
+                TraceChunk * next(chunk->next.load());
+                delete chunk;
+                chunk = next;
+            }
+        }
+    };
+
+    std::atomic<bool> _recording(false);
+    std::atomic<int> _generation(0); // Incremented when a recording starts
+    std::mutex _registry_mutex;
+    std::vector<std::unique_ptr<ThreadTrace> > _registry;
+
+    // Releases the trace of the thread when it ends
+    struct ThreadTraceHandle{
+        ThreadTrace * trace;
+
+        ThreadTraceHandle() : trace(nullptr) {}
+        ~ThreadTraceHandle()
+        {
+            if(trace)
+            {
+                std::lock_guard<std::mutex> lock(_registry_mutex);
+                trace->in_use = false;
+            }
+        }
+    };
+
+    thread_local ThreadTraceHandle _thread_trace;
+    thread_local const char * _thread_name(nullptr); // Kept while not recording
+
+    TraceRecorder::Clock::time_point epoch()
+    {
+        static const TraceRecorder::Clock::time_point _EPOCH(TraceRecorder::Clock::now());
+        return _EPOCH;
+    }
+
+    long long to_us(TraceRecorder::Clock::time_point p_time)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(p_time - epoch()).count();
+    }
+
+    // Registers the calling thread on first use, and resets its trace on first use in each recording
+    ThreadTrace * thread_trace()
+    {
+        int generation(_generation.load());
+        ThreadTrace * trace(_thread_trace.trace);
+        if(trace && trace->generation == generation) // Only written by this thread
+            return trace;
+
+        std::lock_guard<std::mutex> lock(_registry_mutex);
+        if(!trace)
+        {
+            for(const std::unique_ptr<ThreadTrace> & released : _registry)
+            {
+                if(!released->in_use && released->generation != generation)
+                {
+                    trace = released.get();
+                    break;
+                }
+            }
+            if(!trace)
+            {
+                _registry.push_back(std::unique_ptr<ThreadTrace>(new ThreadTrace(_registry.size()+1)));
+                trace = _registry.back().get();
+            }
+            trace->in_use = true;
+            _thread_trace.trace = trace;
+        }
+        trace->reset(generation);
+        trace->name = _thread_name;
+        return trace;
+    }
+
+    void write_escaped(std::ofstream & p_stream, const char * p_string)
+    {
+        for(; *p_string; p_string++)
+        {
+            if(*p_string == '"' || *p_string == '\\')
+                p_stream << '\\';
+            p_stream << *p_string;
+        }
+    }
+}
+
+/*********
+ * SCOPE *
+ *********/
+TraceRecorder::Scope::Scope(const char * p_name) : m_name(p_name), m_recording(isRecording())
+{
+    if(m_recording)
+        m_start = Clock::now();
+}
+
+TraceRecorder::Scope::~Scope()
+{
+    if(m_recording)
+        record(m_name, m_start, Clock::now());
+}
+
+/******************
+ * TRACE RECORDER *
+ ******************/
+void TraceRecorder::start()
+{
+    epoch();
+    _generation++; // Previous events are dropped as each thread records again
+    _recording.store(true);
+}
+
+void TraceRecorder::stop()
+{
+    _recording.store(false);
+}
+
+bool TraceRecorder::isRecording()
+{
+    return _recording.load(std::memory_order_relaxed);
+}
+
+void TraceRecorder::setThreadName(const char * p_name)
+{
+    _thread_name = p_name;
+    if(!isRecording())
+        return;
+
+    ThreadTrace * trace(thread_trace());
+    std::lock_guard<std::mutex> lock(_registry_mutex);
+    trace->name = p_name;
+}
+
+void TraceRecorder::record(const char * p_name, Clock::time_point p_start, Clock::time_point p_end)
+{
+    if(!isRecording())
+        return;
+
+    ThreadTrace * trace(thread_trace());
+    TraceChunk * chunk(trace->tail);
+    int size(chunk->size.load(std::memory_order_relaxed));
+    if(size == TraceChunk::_CAPACITY)
+    {
+        TraceChunk * next(new TraceChunk);
+        chunk->next.store(next, std::memory_order_release);
+        trace->tail = chunk = next;
+        size = 0;
+    }
+
+    long long start(to_us(p_start));
+    chunk->events[size] = TraceEvent{p_name, start, to_us(p_end) - start};
+    chunk->size.store(size+1, std::memory_order_release);
+}
+
+bool TraceRecorder::write(const std::string & p_filename)
+{
+    std::ofstream file(p_filename.c_str(), std::ios::out | std::ios::trunc);
+    if(!file.is_open())
+        return false;
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first(true);
+
+    std::lock_guard<std::mutex> lock(_registry_mutex);
+    int generation(_generation.load());
+    for(const std::unique_ptr<ThreadTrace> & trace : _registry)
+    {
+        if(trace->generation != generation)
+            continue;
+
+        if(trace->name)
+        {
+            file << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << trace->tid << ",\"args\":{\"name\":\"";
+            write_escaped(file, trace->name);
+            file << "\"}}";
+            first = false;
+        }
+
+        for(const TraceChunk * chunk(&trace->head); chunk; chunk = chunk->next.load(std::memory_order_acquire))
+        {
+            int size(chunk->size.load(std::memory_order_acquire));
+            for(int i(0); i < size; i++)
+            {
+                const TraceEvent & event(chunk->events[i]);
+                file << (first ? "\n" : ",\n") << "{\"name\":\"";
+                write_escaped(file, event.name);
+                file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << trace->tid << ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "}";
+                first = false;
+            }
+        }
+    }
+    file << "\n]}\n";
+
+    return file.good();
+}
@@ -0,0 +1,42 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <string>
+#include <chrono>
+
+/**
+ * Optional timeline of what each thread is doing, written as a Chrome trace-event JSON file
+ * (chrome://tracing, ui.perfetto.dev). Events are appended to per-thread buffers without locking; the
+ * buffers are only read when the trace is written. Event and thread names must be string literals or
+ * otherwise outlive the recording. When not recording, a scope costs one flag check.
+ */
+class TraceRecorder
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * Records the enclosing scope as a complete event
+     */
+    class Scope
+    {
+    public:
+        Scope(const char * p_name);
+        ~Scope();
+
+    private:
+        const char * m_name;
+        bool m_recording;
+        Clock::time_point m_start;
+    };
+
+    static void start(); // Discards any previous trace
+    static void stop();
+    static bool isRecording();
+    static bool write(const std::string & p_filename); // Once stopped
+
+    static void setThreadName(const char * p_name); // Names the calling thread in the trace
+    static void record(const char * p_name, Clock::time_point p_start, Clock::time_point p_end);
+};
+
+#endif // TRACE_RECORDER_H
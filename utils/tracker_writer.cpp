@@ -0,0 +1,157 @@
+#include "tracker_writer.h"
+#include "callback_listener.h"
+#include "trace_recorder.h"
+
+#include <ecotracker/tracker.h>
+#include <sqlite3.h>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QDebug>
+#include <ctime>
+#include <algorithm>
+
+namespace {
+    // Memory-backed when possible: the default temporary directory may be on a network file system
+    QString default_results_root()
+    {
+        static const QString _ROOT(QDir("/dev/shm").exists() ? QString("/dev/shm") : QDir::tempPath());
+        return _ROOT;
+    }
+}
+
+TrackerWriter & TrackerWriter::instance()
+{
+    static TrackerWriter _INSTANCE;
+    return _INSTANCE;
+}
+
+unsigned long TrackerWriter::timestamp()
+{
+    static std::mutex _MUTEX;
+    static unsigned long _LAST(0);
+    std::lock_guard<std::mutex> lock(_MUTEX);
+    _LAST = std::max(_LAST + 1, (unsigned long) std::time(nullptr));
+    return _LAST;
+}
+
+TrackerWriter::TrackerWriter() : m_pending(), m_submitted_count(0), m_written_count(0), m_exit(false), m_write_ahead_log_checked(false)
+{
+}
+
+TrackerWriter::~TrackerWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exit = true;
+    }
+    m_condition.notify_all();
+    if(m_writer.joinable())
+        m_writer.join();
+}
+
+void TrackerWriter::submit(Entry && p_entry)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.push_back(std::move(p_entry));
+    m_submitted_count++;
+    if(!m_writer.joinable())
+        m_writer = std::thread(&TrackerWriter::run, this);
+    m_condition.notify_all();
+}
+
+void TrackerWriter::setResultsDirectory(const QString & p_directory)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_results_directory = p_directory;
+}
+
+void TrackerWriter::setDatabaseFile(const QString & p_database_file)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_database_file = p_database_file;
+}
+
+void TrackerWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    long submitted_count(m_submitted_count);
+    m_condition.wait(lock, [this, submitted_count]{ return m_written_count >= submitted_count; });
+}
+
+/***********
+ * PRIVATE *
+ ***********/
+void TrackerWriter::run()
+{
+    TraceRecorder::setThreadName("tracker_writer");
+    std::vector<Entry> batch;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(true)
+    {
+        m_condition.wait(lock, [this]{ return m_exit || !m_pending.empty(); });
+        if(m_pending.empty()) // Exiting
+            return;
+
+        batch.swap(m_pending);
+        QString results_directory(m_results_directory);
+        QString database_file(m_write_ahead_log_checked ? QString() : m_database_file);
+        m_write_ahead_log_checked = true;
+        lock.unlock();
+        if(!database_file.isEmpty() && !enable_write_ahead_log(database_file))
+            qWarning() << "Unable to switch the results database to write-ahead logging:" << database_file;
+        {
+            TraceRecorder::Scope trace("tracker_batch");
+            for(const Entry & entry : batch)
+            {
+                write(entry, results_directory);
+                if(entry.completion_listener)
+                    entry.completion_listener->complete();
+            }
+        }
+        int written_count(batch.size());
+        batch.clear();
+        lock.lock();
+
+        m_written_count += written_count;
+        m_condition.notify_all();
+    }
+}
+
+void TrackerWriter::write(const Entry & p_entry, const QString & p_results_directory)
+{
+    bool keep(!p_results_directory.isEmpty());
+    if(keep)
+        QDir().mkpath(p_results_directory);
+
+    QTemporaryDir results((keep ? p_results_directory : default_results_root()) + "/ecosim_analysis_XXXXXX");
+    results.setAutoRemove(!keep);
+    if(!results.isValid() || !RadialDistributionAnalyzer::write(p_entry.distributions, results.path()))
+    {
+        qCritical() << "Failed to hand the statistical snapshot over to the tracker...";
+        return;
+    }
+
+    Tracker::addEntry(p_entry.timestamp, p_entry.slope, p_entry.humidities, p_entry.illuminations, p_entry.temperatures, p_entry.elapsed_months,
+                      p_entry.specie_ids, results);
+}
+
+bool TrackerWriter::enable_write_ahead_log(const QString & p_database_file)
+{
+    sqlite3 * database(nullptr);
+    if(sqlite3_open_v2(p_database_file.toUtf8().constData(), &database, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK)
+    {
+        sqlite3_close(database);
+        return false;
+    }
+    sqlite3_busy_timeout(database, 5000); // A reader may hold the database
+
+    // Answers the resulting mode, which stays the previous one if the switch is refused
+    bool enabled(false);
+    sqlite3_stmt * statement(nullptr);
+    if(sqlite3_prepare_v2(database, "PRAGMA journal_mode=WAL", -1, &statement, nullptr) == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW)
+        enabled = (QString((const char*) sqlite3_column_text(statement, 0)).toLower() == "wal");
+    sqlite3_finalize(statement);
+    sqlite3_close(database);
+
+    return enabled;
+}
@@ -0,0 +1,75 @@
+#ifndef TRACKER_WRITER_H
+#define TRACKER_WRITER_H
+
+#include <vector>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <QString>
+
+#include "../simulator/analysis/radial_distribution_analyzer.h"
+
+class CallbackListener;
+
+/**
+ * Single writer of the results database for every simulation of the process. Entries are queued without waiting
+ * and written from one long-lived thread, created on the first submission. Each wake-up writes everything queued
+ * meanwhile back to back, in submission order, so concurrent simulations never contend for the database.
+ *
+ * Analysis results stay in memory until written. The prebuilt tracker only reads them from a directory, so they are
+ * serialized there right before the entry is added and removed right after, in memory-backed storage (/dev/shm)
+ * when available.
+ *
+ * When the tracker's database file is known, it is switched to write-ahead logging before the first write: commits
+ * then append to the log instead of rewriting a rollback journal, and readers of the results no longer block the
+ * writer. The tracker opens its own connection and issues its own statements for every entry, so the batch cannot be
+ * wrapped in a single transaction nor its inserts prepared once from here.
+ */
+class TrackerWriter
+{
+public:
+    struct Entry{
+        unsigned long timestamp;
+        int slope;
+        std::vector<int> humidities;
+        std::vector<int> illuminations;
+        std::vector<int> temperatures;
+        int elapsed_months;
+        std::set<int> specie_ids;
+        std::vector<RadialDistribution> distributions;
+        CallbackListener * completion_listener; // Optional, called from the writer thread once the entry is written
+    };
+
+    static TrackerWriter & instance();
+    // Seconds since the epoch, like the prebuilt analyser's. Bumped past the previous one so entries never share it
+    static unsigned long timestamp();
+    ~TrackerWriter(); // Writes the pending entries
+
+    void submit(Entry && p_entry); // Never waits for the database
+    void flush(); // Blocks until every entry submitted so far has been written
+
+    // Debug: keeps the results handed to the tracker, one subdirectory per entry. Empty --> removed once written
+    void setResultsDirectory(const QString & p_directory);
+    // The tracker's results database. Empty --> journal mode left to the tracker
+    void setDatabaseFile(const QString & p_database_file);
+
+private:
+    TrackerWriter();
+    void run();
+    void write(const Entry & p_entry, const QString & p_results_directory);
+    static bool enable_write_ahead_log(const QString & p_database_file);
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<Entry> m_pending;
+    long m_submitted_count;
+    long m_written_count;
+    bool m_exit;
+    QString m_results_directory;
+    QString m_database_file;
+    bool m_write_ahead_log_checked; // Once per process, before the first write. The journal mode is persistent
+    std::thread m_writer;
+};
+
+#endif // TRACKER_WRITER_H
@@ -1,10 +1,10 @@
 #include "utils.h"
 #include <math.h>
 
-QPoint Utils::getRandomPointInCircle(QPoint center, int radius)
+QPoint Utils::getRandomPointInCircle(QPoint center, int radius, RandomStream & random_stream)
 {
-    int distance(rand() % radius);
-    float angle_in_radians((((float)rand())/RAND_MAX) * 2 * M_PI);
+    int distance(random_stream.uniformInt(0, radius-1));
+    float angle_in_radians(random_stream.uniformFloat() * 2 * M_PI);
 
     QPoint diff(cos(angle_in_radians) * distance, sin(angle_in_radians) * distance);
 
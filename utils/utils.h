@@ -2,9 +2,10 @@
 #define UTILS_H
 
 #include <QPoint>
+#include "../math/random_streams.h"
 
 namespace Utils{
-    QPoint getRandomPointInCircle(QPoint center, int radius);
+    QPoint getRandomPointInCircle(QPoint center, int radius, RandomStream & random_stream);
 }
 
 #endif // UTILS_H